@@ -0,0 +1,35 @@
+#include "G2dConversionServer.hpp"
+
+#include <csignal>
+#include <iostream>
+#include <string>
+
+namespace {
+    G2dConversionServer* activeServer = nullptr;
+
+    void handleSignal(int /*signal*/) {
+        if(activeServer != nullptr) {
+            activeServer->stop();
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::string socketPath = argc > 1 ? argv[1] : "/tmp/g2dconvert.sock";
+
+    G2dConversionServer server(socketPath);
+    if(server.start() != G2dConversionServerStatus::SUCCESS) {
+        std::cerr << "Failed to start the conversion server" << "\n";
+        return -1;
+    }
+
+    activeServer = &server;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    std::cout << "Listening on " << socketPath << "\n";
+    const G2dConversionServerStatus status = server.run();
+    activeServer = nullptr;
+
+    return status == G2dConversionServerStatus::SUCCESS ? 0 : -1;
+}
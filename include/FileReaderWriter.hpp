@@ -6,6 +6,8 @@
 #include <span>
 #include <fstream>
 
+#include "G2dFrameAllocator.hpp"
+
 enum class FileReaderWriterStatus {
     SUCCESS,
     FILE_OPEN_FAILURE
@@ -30,4 +32,20 @@ public:
         const std::string& filename, 
         std::vector<uint8_t>& buffer
     );
+
+    /// @brief Read a raw image file into an aligned frame buffer, without zeroing it first
+    /// @param filename image source
+    /// @param buffer buffer to fill with the image data
+    /// @return FileReaderWriterStatus::SUCCESS on success, FileReaderWriterStatus::FILE_OPEN_FAILURE on failure
+    FileReaderWriterStatus readFileRaw(
+        const std::string& filename, 
+        G2dFrameBuffer& buffer
+    );
+
+private:
+    template<typename Buffer>
+    FileReaderWriterStatus readFileInto(
+        const std::string& filename, 
+        Buffer& buffer
+    );
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef G2D_WITH_IO_URING
+#include <liburing.h>
+#endif
+
+enum class G2dAsyncFileIoBackend {
+    THREAD_POOL = 0,
+    IO_URING = 1,
+};
+
+/// @brief Asynchronous whole-file reads and writes
+/// When the library is built with G2D_WITH_IO_URING and the kernel supports it, requests
+/// are batched into an io_uring submission queue and served by a single thread. Otherwise
+/// they are served by a small pool of threads using blocking I/O.
+class G2dAsyncFileIo {
+    public:
+        /// @brief Called on an I/O thread once a request is done
+        using Completion = std::function<void(bool success)>;
+
+        /// @brief Constructor for G2dAsyncFileIo
+        /// @param threadCount Number of threads used by the thread pool backend
+        /// @param queueDepth Number of io_uring submission queue entries
+        explicit G2dAsyncFileIo(size_t threadCount = 2, unsigned queueDepth = 64);
+
+        /// @brief Finishes all queued requests and stops the I/O threads
+        ~G2dAsyncFileIo();
+
+        G2dAsyncFileIo(const G2dAsyncFileIo&) = delete;
+        G2dAsyncFileIo& operator=(const G2dAsyncFileIo&) = delete;
+        G2dAsyncFileIo(G2dAsyncFileIo&&) = delete;
+        G2dAsyncFileIo& operator=(G2dAsyncFileIo&&) = delete;
+
+        /// @brief Reads a whole file
+        /// @param path File to read
+        /// @param buffer Resized to the file size and filled with its contents. Must stay alive until completion
+        /// @param completion Called with the result of the read
+        void read(const std::string& path, std::vector<uint8_t>& buffer, Completion completion);
+
+        /// @brief Writes a whole file, replacing any existing one
+        /// @param path File to write
+        /// @param buffer Data to write. Must stay alive until completion
+        /// @param completion Called with the result of the write
+        void write(const std::string& path, std::span<const uint8_t> buffer, Completion completion);
+
+        /// @brief Gets the backend serving the requests
+        G2dAsyncFileIoBackend backend() const;
+
+    private:
+        struct Request {
+            bool isWrite = false;
+            std::string path;
+            std::vector<uint8_t>* readBuffer = nullptr;
+            std::span<const uint8_t> writeBuffer;
+            Completion completion;
+            int fd = -1;
+            size_t done = 0;
+        };
+
+        void enqueue(Request request);
+        void runThreadPool();
+        static bool serveBlocking(Request& request);
+
+        G2dAsyncFileIoBackend mBackend = G2dAsyncFileIoBackend::THREAD_POOL;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<Request> mRequests;
+        bool mStopping = false;
+        std::vector<std::thread> mThreads;
+
+#ifdef G2D_WITH_IO_URING
+        void runRing();
+        bool submitRing(Request* request);
+
+        io_uring mRing {};
+        int mWakeFd = -1;
+        size_t mInFlight = 0;
+#endif
+};
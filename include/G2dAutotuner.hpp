@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "G2dTuningTable.hpp"
+
+/// @brief Measures the fastest way to run conversions on the current board
+/// For every conversion, the accelerator and the CPU kernels with several thread counts
+/// and band sizes are timed on a synthetic frame, and the fastest configuration is
+/// stored in a G2dTuningTable. Converters given the table then use the measured best
+/// configuration instead of a hand tuned one.
+class G2dAutotuner {
+    public:
+        /// @brief Constructor for G2dAutotuner
+        /// @param iterations Number of timed conversions per candidate, the median is kept
+        /// @param maxThreads Largest CPU thread count tried, 0 for the number of hardware threads
+        explicit G2dAutotuner(size_t iterations = 5, size_t maxThreads = 0);
+
+        /// @brief Measures the given conversions and stores the fastest configurations
+        /// @param keys Conversions to measure
+        /// @param table Table to store the results in
+        /// @return G2dTuningStatus::SUCCESS on success, G2dTuningStatus::CALIBRATION_ERROR if
+        /// a conversion could not be run with any configuration
+        G2dTuningStatus calibrate(const std::vector<G2dTuningKey>& keys, G2dTuningTable& table) const;
+
+        /// @brief Loads a tuning file, measuring and saving only the conversions missing from it
+        /// Intended to be called once at startup, so only the first run on a board pays for the measurement.
+        /// @param path Path of the tuning file
+        /// @param keys Conversions in use
+        /// @param table Table to store the results in
+        /// @return G2dTuningStatus::SUCCESS on success, one of the errors defined in G2dTuningStatus on failure
+        G2dTuningStatus loadOrCalibrate(const std::string& path, const std::vector<G2dTuningKey>& keys, G2dTuningTable& table) const;
+
+    private:
+        size_t mIterations;
+        size_t mMaxThreads;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <g2d.h>
+#include <cstddef>
+#include <vector>
+
+/// @brief A pool of reusable G2D DMA buffers
+/// Allocating contiguous memory for the accelerator is expensive, so buffers
+/// released back to the pool are kept and handed out again to later requests
+/// of the same or smaller size.
+class G2dBufferPool {
+    public:
+        /// @brief Constructor for G2dBufferPool
+        /// @param maxIdleBuffers Maximum number of released buffers kept for reuse
+        explicit G2dBufferPool(size_t maxIdleBuffers = 8);
+        ~G2dBufferPool();
+
+        G2dBufferPool(const G2dBufferPool&) = delete;
+        G2dBufferPool& operator=(const G2dBufferPool&) = delete;
+        G2dBufferPool(G2dBufferPool&&) = delete;
+        G2dBufferPool& operator=(G2dBufferPool&&) = delete;
+
+        /// @brief Gets a buffer of at least the requested size
+        /// @param size Requested buffer size in bytes
+        /// @return Pointer to a G2D buffer on success, nullptr if the allocation failed
+        g2d_buf* acquire(size_t size);
+
+        /// @brief Returns a buffer obtained from acquire() to the pool
+        /// @param buf Buffer to return. The buffer is freed if the pool is full
+        /// @return true on success, false if freeing the buffer failed
+        bool release(g2d_buf* buf);
+
+        /// @brief Frees all idle buffers held by the pool
+        /// @return true on success, false if any of the buffers could not be freed
+        bool clear();
+
+        /// @brief Gets the number of idle buffers held by the pool
+        size_t idleBufferCount() const;
+
+    private:
+        size_t mMaxIdleBuffers;
+        std::vector<g2d_buf*> mIdleBuffers;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "G2dAsyncFileIo.hpp"
+#include "G2dConcurrentConverter.hpp"
+#include "formats.hpp"
+
+enum class G2dBulkConverterStatus {
+    SUCCESS = 0,
+    DIRECTORY_ERROR = -1,
+    CONVERSION_ERROR = -2,
+    DUPLICATE_OUTPUT_ERROR = -3,
+};
+
+/// @brief Result of a bulk conversion
+struct G2dBulkConversionSummary {
+    /// @brief Number of files converted and written successfully
+    size_t converted = 0;
+
+    /// @brief Source files that could not be read, converted or written, or that share their output path with another file
+    std::vector<std::string> failedFiles;
+};
+
+/// @brief Converts many raw frame files in one go
+/// Files are read asynchronously, converted by a G2dConcurrentConverter and written back
+/// asynchronously. Up to maxInFlight files are in the pipeline at once, so reading,
+/// converting and writing of different files overlap.
+class G2dBulkConverter {
+    public:
+        /// @brief Constructor for G2dBulkConverter
+        /// @param workerCount Number of conversion workers
+        /// @param ioThreadCount Number of I/O threads used when io_uring is not available
+        /// @param maxInFlight Maximum number of files held in memory at once
+        explicit G2dBulkConverter(size_t workerCount = 2, size_t ioThreadCount = 2, size_t maxInFlight = 8);
+
+        /// @brief Converts every regular file in a directory
+        /// @param srcFormat Format of the source files
+        /// @param destFormat Format of the converted files
+        /// @param srcDirectory Directory containing the source files
+        /// @param destDirectory Directory the converted files are written to, created if missing
+        /// @param destExtension Extension of the converted files, without the dot (e.g. "rgba")
+        /// @param srcWidth Width of the source images in pixels
+        /// @param srcHeight Height of the source images in pixels
+        /// @param destWidth Width of the destination images in pixels
+        /// @param destHeight Height of the destination images in pixels
+        /// @param summary Filled with the number of converted files and the failed ones
+        /// @return G2dBulkConverterStatus::SUCCESS if every file was converted, one of the errors
+        /// defined in G2dBulkConverterStatus otherwise
+        G2dBulkConverterStatus convertDirectory(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const std::string& srcDirectory,
+            const std::string& destDirectory,
+            const std::string& destExtension,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            G2dBulkConversionSummary& summary
+        );
+
+        /// @brief Converts a list of files
+        /// Each output is named after the stem of its source file. If two sources would be written
+        /// to the same output, as "a.yuv" and "a.raw" or files of the same name in different
+        /// directories would, nothing is converted and G2dBulkConverterStatus::DUPLICATE_OUTPUT_ERROR is returned.
+        /// @param srcFiles Paths of the source files
+        /// The other parameters are the same as for convertDirectory()
+        G2dBulkConverterStatus convertFiles(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const std::vector<std::string>& srcFiles,
+            const std::string& destDirectory,
+            const std::string& destExtension,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            G2dBulkConversionSummary& summary
+        );
+
+        /// @brief Gets the backend used for file I/O
+        G2dAsyncFileIoBackend ioBackend() const;
+
+    private:
+        size_t mMaxInFlight;
+        G2dConcurrentConverter mConverter;
+        G2dAsyncFileIo mFileIo;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "G2dMpscQueue.hpp"
+#include "G2dPixelFormatConverter.hpp"
+#include "formats.hpp"
+
+/// @brief A thread-safe pixel format converter
+/// Any number of threads can submit conversions at the same time. Every worker owns
+/// its own G2dPixelFormatConverter session and a lock-free submission queue, so
+/// submitting a frame never takes a lock and producers do not contend with each other.
+class G2dConcurrentConverter {
+    public:
+        /// @brief Called on the worker thread once a submitted conversion is done
+        using CompletionCallback = std::function<void(G2dPixelFormatConverterStatus)>;
+
+        /// @brief Constructor for G2dConcurrentConverter
+        /// @param workerCount Number of worker threads, each with its own device session
+        explicit G2dConcurrentConverter(size_t workerCount = 1);
+
+        /// @brief Finishes all submitted conversions and stops the workers
+        ~G2dConcurrentConverter();
+
+        G2dConcurrentConverter(const G2dConcurrentConverter&) = delete;
+        G2dConcurrentConverter& operator=(const G2dConcurrentConverter&) = delete;
+        G2dConcurrentConverter(G2dConcurrentConverter&&) = delete;
+        G2dConcurrentConverter& operator=(G2dConcurrentConverter&&) = delete;
+
+        /// @brief Submits a conversion and returns a future for its result
+        /// Both buffers must stay alive and untouched until the conversion is done.
+        /// The parameters are the same as for G2dPixelFormatConverter::convertImage()
+        /// @return Future that becomes ready with the conversion status
+        std::future<G2dPixelFormatConverterStatus> submit(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const std::vector<uint8_t>& srcBuffer,
+            std::vector<uint8_t>& destBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight
+        );
+
+        /// @brief Submits a conversion and calls a callback when it is done
+        /// Both buffers must stay alive and untouched until the callback is called.
+        /// The parameters are the same as for G2dPixelFormatConverter::convertImage()
+        /// @param callback Called on the worker thread with the conversion status
+        void submit(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const std::vector<uint8_t>& srcBuffer,
+            std::vector<uint8_t>& destBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            CompletionCallback callback
+        );
+
+        /// @brief Gets the number of worker threads
+        size_t workerCount() const;
+
+    private:
+        /// @brief A submitted conversion, linked into a worker queue
+        struct Job {
+            std::atomic<Job*> next = nullptr;
+            OrqaG2dFormat srcFormat = OrqaG2dFormat::FMT_RGB565;
+            OrqaG2dFormat destFormat = OrqaG2dFormat::FMT_RGB565;
+            const std::vector<uint8_t>* srcBuffer = nullptr;
+            std::vector<uint8_t>* destBuffer = nullptr;
+            size_t srcWidth = 0;
+            size_t srcHeight = 0;
+            size_t destWidth = 0;
+            size_t destHeight = 0;
+            std::optional<std::promise<G2dPixelFormatConverterStatus>> promise;
+            CompletionCallback callback;
+        };
+
+        /// @brief A worker thread with its own queue and device session
+        struct Worker {
+            G2dMpscQueue<Job> queue;
+            /// @brief Number of jobs submitted to the worker and not yet taken by it, counted before the push
+            alignas(64) std::atomic<size_t> pending = 0;
+            /// @brief Bumped on every push and on shutdown, the worker sleeps on it when idle
+            std::atomic<uint32_t> signal = 0;
+            std::atomic<bool> stopping = false;
+            std::thread thread;
+        };
+
+        void enqueue(Job* job);
+        static void runWorker(Worker& worker);
+
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+};
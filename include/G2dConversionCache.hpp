@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "formats.hpp"
+
+/// @brief Identifies a conversion result by the content of its source and its parameters
+struct G2dConversionCacheKey {
+    uint64_t srcHash = 0;
+    uint64_t srcSize = 0;
+    OrqaG2dFormat srcFormat = OrqaG2dFormat::FMT_RGB565;
+    OrqaG2dFormat destFormat = OrqaG2dFormat::FMT_RGB565;
+    uint64_t srcWidth = 0;
+    uint64_t srcHeight = 0;
+    uint64_t destWidth = 0;
+    uint64_t destHeight = 0;
+
+    /// @brief Whether the result comes from the CPU kernels rather than the accelerator, whose output can differ slightly
+    bool onCpu = false;
+
+    bool operator==(const G2dConversionCacheKey& other) const = default;
+};
+
+/// @brief Usage statistics of a G2dConversionCache
+struct G2dConversionCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    /// @brief Number of cached results
+    size_t entries = 0;
+    /// @brief Memory used by the cached results in bytes
+    size_t bytes = 0;
+
+    /// @brief Gets the share of lookups served from the cache, between 0 and 1
+    double hitRate() const {
+        const uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+};
+
+/// @brief Bounded least-recently-used cache of conversion results
+/// Results are keyed by an XXH64 hash of the source frame plus the conversion parameters.
+/// Sources are not stored, so a hash collision between two different frames of the same
+/// size and format would return the wrong result. With a 64 bit hash this is negligible
+/// for video feeds, but the cache should not be used where that is not acceptable.
+class G2dConversionCache {
+    public:
+        /// @brief Constructor for G2dConversionCache
+        /// @param maxBytes Maximum memory used by cached results. The least recently used results are evicted beyond it
+        explicit G2dConversionCache(size_t maxBytes);
+
+        /// @brief Builds the cache key of a conversion
+        static G2dConversionCacheKey makeKey(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            std::span<const uint8_t> srcBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            bool onCpu
+        );
+
+        /// @brief Looks up a cached result and marks it as most recently used
+        /// @param key Key of the conversion
+        /// @return View of the cached result, or an empty span on a miss. Valid until the next insert()
+        std::span<const uint8_t> lookup(const G2dConversionCacheKey& key);
+
+        /// @brief Stores a conversion result, evicting old results as needed
+        /// @param key Key of the conversion
+        /// @param result Converted frame. Results larger than the cache itself are not stored
+        void insert(const G2dConversionCacheKey& key, std::span<const uint8_t> result);
+
+        /// @brief Removes all cached results. Statistics are kept
+        void clear();
+
+        /// @brief Gets the usage statistics of the cache
+        G2dConversionCacheStats stats() const;
+
+    private:
+        struct KeyHash {
+            size_t operator()(const G2dConversionCacheKey& key) const;
+        };
+
+        struct Entry {
+            G2dConversionCacheKey key;
+            std::vector<uint8_t> result;
+        };
+
+        size_t mMaxBytes;
+        std::list<Entry> mEntries;
+        std::unordered_map<G2dConversionCacheKey, std::list<Entry>::iterator, KeyHash> mIndex;
+        G2dConversionCacheStats mStats;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "G2dPixelFormatConverter.hpp"
+#include "G2dSharedFrame.hpp"
+#include "formats.hpp"
+
+/// @brief Client of a G2dConversionServer
+/// Mirrors the G2dPixelFormatConverter::convertImage() interface, but the conversion
+/// itself is done by the server process, which keeps the device open for all clients.
+class G2dConversionClient {
+    public:
+        /// @brief Constructor for G2dConversionClient
+        /// @param socketPath Filesystem path the server listens on
+        explicit G2dConversionClient(std::string socketPath);
+        ~G2dConversionClient();
+
+        G2dConversionClient(const G2dConversionClient&) = delete;
+        G2dConversionClient& operator=(const G2dConversionClient&) = delete;
+        G2dConversionClient(G2dConversionClient&&) = delete;
+        G2dConversionClient& operator=(G2dConversionClient&&) = delete;
+
+        /// @brief Connects to the server. Called automatically by convertImage() when needed
+        /// @return G2dPixelFormatConverterStatus::SUCCESS on success, G2dPixelFormatConverterStatus::CONNECTION_ERROR on failure
+        G2dPixelFormatConverterStatus connect();
+
+        /// @brief Closes the connection to the server
+        void disconnect();
+
+        /// @brief Converts an image on the server
+        /// The source is copied into a shared memory frame kept by the client and the result is
+        /// copied out of another one. Use the G2dSharedFrame overload to avoid both copies.
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param srcBuffer Vector containing source image data
+        /// @param destBuffer Vector to store converted image data (will be resized as needed)
+        /// @param srcWidth Width of the source image in pixels
+        /// @param srcHeight Height of the source image in pixels
+        /// @param destWidth Width of the destination image in pixels
+        /// @param destHeight Height of the destination image in pixels
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const std::vector<uint8_t>& srcBuffer,
+            std::vector<uint8_t>& destBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight
+        );
+
+        /// @brief Converts an image stored in shared memory frames on the server, without copying it
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param srcFrame Shared memory frame containing source image data
+        /// @param destFrame Shared memory frame to store the converted image in. Must be large enough to hold the destination frame
+        /// @param srcWidth Width of the source image in pixels
+        /// @param srcHeight Height of the source image in pixels
+        /// @param destWidth Width of the destination image in pixels
+        /// @param destHeight Height of the destination image in pixels
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const G2dSharedFrame& srcFrame,
+            G2dSharedFrame& destFrame,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight
+        );
+
+    private:
+        std::string mSocketPath;
+        int mSocketFd = -1;
+
+        /// @brief Frames reused by the std::vector overload of convertImage()
+        G2dSharedFrame mSrcFrame;
+        G2dSharedFrame mDestFrame;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "G2dOverlayLayer.hpp"
+#include "formats.hpp"
+
+/// @brief One destination of a conversion that writes several outputs from the same source frame
+struct G2dConversionOutput {
+    /// @brief Format of the output image
+    OrqaG2dFormat format;
+
+    /// @brief Width of the output image in pixels
+    size_t width;
+
+    /// @brief Height of the output image in pixels
+    size_t height;
+
+    /// @brief Memory to store the output image in. Must be large enough to hold the output frame
+    std::span<uint8_t> buffer;
+
+    /// @brief Layers blended on top of the output, bottom layer first
+    std::span<const G2dOverlayLayer> overlays = {};
+};
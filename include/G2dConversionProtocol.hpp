@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+/// @brief Magic value identifying conversion protocol messages ("G2DC")
+constexpr uint32_t G2dConversionProtocolMagic = 0x47324443;
+
+/// @brief Version of the conversion protocol, bumped on incompatible changes
+constexpr uint32_t G2dConversionProtocolVersion = 1;
+
+/// @brief Largest image width or height the conversion server accepts
+constexpr uint64_t G2dConversionMaxDimension = 16384;
+
+/// @brief Conversion request sent by a client to the conversion server
+/// The source and destination frames are not part of the message. They are passed
+/// as two shared memory file descriptors (source first) attached to the request.
+struct G2dConversionRequest {
+    uint32_t magic;
+    uint32_t version;
+    int32_t srcFormat;
+    int32_t destFormat;
+    uint64_t srcWidth;
+    uint64_t srcHeight;
+    uint64_t destWidth;
+    uint64_t destHeight;
+    uint64_t srcSize;
+    uint64_t destSize;
+};
+
+/// @brief Reply sent by the conversion server once a request is done
+struct G2dConversionResponse {
+    /// @brief G2dPixelFormatConverterStatus value of the conversion
+    int32_t status;
+    uint32_t reserved;
+    /// @brief Number of bytes written to the destination frame
+    uint64_t destSize;
+};
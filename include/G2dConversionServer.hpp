@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "G2dConversionProtocol.hpp"
+#include "G2dPixelFormatConverter.hpp"
+
+enum class G2dConversionServerStatus {
+    SUCCESS = 0,
+    SOCKET_ERROR = -1,
+    DEVICE_ERROR = -2,
+};
+
+/// @brief A long running conversion server that owns a single device session
+/// Clients connect over a Unix domain socket and submit G2dConversionRequest messages.
+/// Frames are passed as shared memory file descriptors, so the pixel data is never
+/// copied through the socket. All requests share one open device and one DMA buffer pool.
+/// Client sockets are non-blocking and partial requests are kept per client, so a client
+/// that stops halfway through a request never holds up the others.
+class G2dConversionServer {
+    public:
+        /// @brief Constructor for G2dConversionServer
+        /// @param socketPath Filesystem path the server listens on
+        explicit G2dConversionServer(std::string socketPath);
+        ~G2dConversionServer();
+
+        G2dConversionServer(const G2dConversionServer&) = delete;
+        G2dConversionServer& operator=(const G2dConversionServer&) = delete;
+        G2dConversionServer(G2dConversionServer&&) = delete;
+        G2dConversionServer& operator=(G2dConversionServer&&) = delete;
+
+        /// @brief Opens the device session and starts listening on the socket
+        /// @return G2dConversionServerStatus::SUCCESS on success, one of the errors defined in G2dConversionServerStatus on failure
+        G2dConversionServerStatus start();
+
+        /// @brief Serves clients until stop() is called
+        /// @return G2dConversionServerStatus::SUCCESS once stopped, G2dConversionServerStatus::SOCKET_ERROR on failure
+        G2dConversionServerStatus run();
+
+        /// @brief Makes run() return. Safe to call from other threads and from signal handlers
+        void stop();
+
+    private:
+        /// @brief A connected client and the request it is sending
+        struct Client {
+            int fd = -1;
+            G2dConversionRequest request {};
+
+            /// @brief Bytes of the request received so far
+            size_t received = 0;
+
+            /// @brief Descriptors received with the request so far
+            std::vector<int> fds;
+        };
+
+        /// @brief Reads what a client has sent and handles its request once it is complete
+        /// @param client The client, whose partial request is kept between calls
+        /// @return false if the client connection should be closed
+        bool handleRequest(Client& client);
+
+        /// @brief Closes a client connection and any descriptors of its partial request
+        static void closeClient(Client& client);
+
+        std::string mSocketPath;
+        int mListenFd = -1;
+        int mWakeFd = -1;
+        std::atomic<bool> mRunning = false;
+        G2dPixelFormatConverter mConverter;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "G2dConversionOutput.hpp"
+#include "formats.hpp"
+
+enum class G2dCpuConverterStatus {
+    SUCCESS = 0,
+    UNSUPPORTED_CONVERSION_ERROR = -1,
+    BUFFER_SIZE_ERROR = -2,
+};
+
+/// @brief Options for splitting a CPU conversion across threads
+struct G2dCpuConversionOptions {
+    /// @brief Number of threads working on a frame, including the calling thread
+    /// The helper threads come from a process-wide pool that is kept between conversions
+    size_t threadCount = 1;
+
+    /// @brief Number of image rows a thread converts at a time, 0 splits the frame evenly between the threads
+    size_t bandRows = 0;
+};
+
+/// @brief Pixel format conversion on the CPU
+/// Covers the conversions that are memory bound, like YUV repacking, RGB to YUV encoding and RGB repacking,
+/// for which a round trip through the accelerator costs more than the conversion itself.
+/// Conversions keep the image size.
+class G2dCpuConverter {
+    public:
+        G2dCpuConverter() = delete;
+
+        /// @brief Checks if a conversion can be done on the CPU
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @return true if the conversion is supported, false otherwise
+        static bool isConversionSupported(OrqaG2dFormat srcFormat, OrqaG2dFormat destFormat, size_t width, size_t height);
+
+        /// @brief Converts an image on the CPU
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param srcBuffer Source image data
+        /// @param destBuffer Memory to store the converted image in. Must be large enough to hold the destination frame
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @param options Threading of the conversion
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dCpuConverterStatus on failure
+        static G2dCpuConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            std::span<const uint8_t> srcBuffer,
+            std::span<uint8_t> destBuffer,
+            size_t width,
+            size_t height,
+            const G2dCpuConversionOptions& options = {}
+        );
+
+        /// @brief Converts an image on the CPU into several outputs of the same size
+        /// The frame is converted in bands of rows, and each band is written to every output
+        /// before moving on, so the source is read from memory only once. An RGB source is
+        /// encoded to YUV once per chroma subsampling, and the other YUV outputs with the same
+        /// subsampling are repacked from the encoded band instead of encoding it again.
+        /// @param srcFormat Source image format
+        /// @param srcBuffer Source image data
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @param outputs Destinations of the conversion. Each must have the size of the source
+        /// and a format isConversionSupported() accepts. Their overlays are blended into each band
+        /// right after it is converted
+        /// @param options Threading of the conversion
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dCpuConverterStatus on failure
+        static G2dCpuConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            std::span<const uint8_t> srcBuffer,
+            size_t width,
+            size_t height,
+            std::span<const G2dConversionOutput> outputs,
+            const G2dCpuConversionOptions& options = {}
+        );
+
+        /// @brief Blends overlay layers on top of an RGB or YUV frame
+        /// Luma and RGB channels are blended per pixel. Chroma samples are blended with the
+        /// average coverage of the pixels sharing them. Only the rows and columns the overlays
+        /// cover are touched.
+        /// @param format Format of the frame
+        /// @param buffer Frame data, blended in place
+        /// @param width Width of the frame in pixels, even for YUV formats
+        /// @param height Height of the frame in pixels, even for YUV formats
+        /// @param overlays Layers to blend, bottom layer first. Parts outside the frame are ignored
+        /// @return SUCCESS on success, one of the errors defined in G2dCpuConverterStatus on failure
+        static G2dCpuConverterStatus blendOverlays(
+            OrqaG2dFormat format,
+            std::span<uint8_t> buffer,
+            size_t width,
+            size_t height,
+            std::span<const G2dOverlayLayer> overlays
+        );
+
+        /// @brief Checks if a conversion can be done in place
+        /// In place conversions keep the frame size, like reordering packed YUV samples,
+        /// swapping the chroma of NV12 and NV21 or reordering RGB channels.
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @return true if the conversion can be done in place, false otherwise
+        static bool isInPlaceConversionSupported(OrqaG2dFormat srcFormat, OrqaG2dFormat destFormat, size_t width, size_t height);
+
+        /// @brief Converts an image in place on the CPU
+        /// @param srcFormat Format of the image in the buffer
+        /// @param destFormat Format to convert the image to
+        /// @param buffer Image data, overwritten with the converted image
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dCpuConverterStatus on failure
+        static G2dCpuConverterStatus convertImageInPlace(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            std::span<uint8_t> buffer,
+            size_t width,
+            size_t height
+        );
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Byte positions of the samples in a packed 4:2:2 macropixel (two pixels, four bytes)
+struct G2dPackedYuvOrder {
+    uint8_t y0;
+    uint8_t u;
+    uint8_t y1;
+    uint8_t v;
+};
+
+/// @brief How the channels of an RGB format are stored
+enum class G2dRgbPacking {
+    /// @brief One byte per channel, at the offsets given in G2dRgbLayout
+    BYTES,
+    /// @brief 16 bit little endian word, red in the top 5 bits, then 6 bits of green and 5 bits of blue
+    RGB565,
+    /// @brief 16 bit little endian word, 5 bits each of red, green and blue from the top, alpha in the lowest bit
+    RGBA5551,
+};
+
+/// @brief Memory layout of an RGB pixel
+struct G2dRgbLayout {
+    G2dRgbPacking packing;
+    uint8_t bytesPerPixel;
+
+    /// @brief Byte offsets of the channels within a pixel, for G2dRgbPacking::BYTES
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    /// @brief The format carries alpha, at byte offset a for G2dRgbPacking::BYTES
+    /// @details 4 byte formats without alpha have their unused byte at offset a
+    bool hasAlpha;
+    uint8_t a;
+};
+
+/// @brief Row level CPU kernels used by the CPU conversion paths
+/// Kernels use NEON when built for ARM and fall back to portable code elsewhere.
+class G2dCpuKernels {
+    public:
+        G2dCpuKernels() = delete;
+
+        /// @brief Checks if two equally laid out rectangular regions hold the same bytes
+        /// @param a First region
+        /// @param b Second region
+        /// @param stride Distance between the starts of two rows in bytes, for both regions
+        /// @param rowBytes Number of bytes compared per row
+        /// @param rows Number of rows
+        /// @return true if the regions are equal, false otherwise
+        static bool regionsEqual(const uint8_t* a, const uint8_t* b, size_t stride, size_t rowBytes, size_t rows);
+
+        /// @brief Interleaves two rows of samples, a0 b0 a1 b1 ...
+        /// @param a First source row
+        /// @param b Second source row
+        /// @param dest Destination row of 2 * count bytes
+        /// @param count Number of samples in each source row
+        static void interleaveRow(const uint8_t* a, const uint8_t* b, uint8_t* dest, size_t count);
+
+        /// @brief Splits a row of interleaved samples, a0 b0 a1 b1 ..., into two rows
+        /// @param src Source row of 2 * count bytes
+        /// @param a First destination row
+        /// @param b Second destination row
+        /// @param count Number of samples in each destination row
+        static void deinterleaveRow(const uint8_t* src, uint8_t* a, uint8_t* b, size_t count);
+
+        /// @brief Averages two rows byte by byte, rounding up
+        /// @param a First source row
+        /// @param b Second source row
+        /// @param dest Destination row, may alias a or b
+        /// @param count Number of bytes in each row
+        static void averageRows(const uint8_t* a, const uint8_t* b, uint8_t* dest, size_t count);
+
+        /// @brief Halves two rows in both directions, each destination byte is the rounded mean of a 2x2 block
+        /// @param a First source row of at least 2 * count bytes
+        /// @param b Second source row of at least 2 * count bytes
+        /// @param dest Destination row
+        /// @param count Number of bytes in the destination row
+        static void downsampleRows2x2(const uint8_t* a, const uint8_t* b, uint8_t* dest, size_t count);
+
+        /// @brief Splits a row of packed 4:2:2 pixels into planar luma and chroma rows
+        /// @param src Source row of 2 * width bytes
+        /// @param order Byte positions of the samples in a macropixel
+        /// @param y Destination luma row of width bytes
+        /// @param u Destination U row of width / 2 bytes
+        /// @param v Destination V row of width / 2 bytes
+        /// @param width Width of the row in pixels, must be even
+        static void unpackPacked422Row(const uint8_t* src, G2dPackedYuvOrder order, uint8_t* y, uint8_t* u, uint8_t* v, size_t width);
+
+        /// @brief Extracts the luma samples of a row of packed 4:2:2 pixels
+        /// @param src Source row of 2 * width bytes
+        /// @param order Byte positions of the samples in a macropixel
+        /// @param y Destination luma row of width bytes
+        /// @param width Width of the row in pixels, must be even
+        static void extractPacked422LumaRow(const uint8_t* src, G2dPackedYuvOrder order, uint8_t* y, size_t width);
+
+        /// @brief Packs planar luma and chroma rows into a row of packed 4:2:2 pixels
+        /// @param y Source luma row of width bytes
+        /// @param u Source U row of width / 2 bytes
+        /// @param v Source V row of width / 2 bytes
+        /// @param order Byte positions of the samples in a macropixel
+        /// @param dest Destination row of 2 * width bytes
+        /// @param width Width of the row in pixels, must be even
+        static void packPacked422Row(const uint8_t* y, const uint8_t* u, const uint8_t* v, G2dPackedYuvOrder order, uint8_t* dest, size_t width);
+
+        /// @brief Reorders the samples of a row of packed 4:2:2 pixels
+        /// @param src Source row of 2 * width bytes
+        /// @param srcOrder Byte positions of the samples in a source macropixel
+        /// @param dest Destination row of 2 * width bytes, may be the same as src
+        /// @param destOrder Byte positions of the samples in a destination macropixel
+        /// @param width Width of the row in pixels, must be even
+        static void reorderPacked422Row(const uint8_t* src, G2dPackedYuvOrder srcOrder, uint8_t* dest, G2dPackedYuvOrder destOrder, size_t width);
+
+        /// @brief Swaps the two samples of every pair in a row of interleaved samples, a0 b0 ... to b0 a0 ...
+        /// @param src Source row of 2 * count bytes
+        /// @param dest Destination row of 2 * count bytes, may be the same as src
+        /// @param count Number of sample pairs
+        static void swapInterleavedRow(const uint8_t* src, uint8_t* dest, size_t count);
+
+        /// @brief Converts two RGB rows to BT.601 limited range YUV 4:2:0
+        /// Chroma is computed from the average of each 2x2 block of pixels.
+        /// @param rgb0 First source row
+        /// @param rgb1 Second source row
+        /// @param layout Pixel layout of the source rows
+        /// @param y0 Destination luma row of the first source row, width bytes
+        /// @param y1 Destination luma row of the second source row, width bytes
+        /// @param u Destination U row of width / 2 bytes
+        /// @param v Destination V row of width / 2 bytes
+        /// @param width Width of the rows in pixels, must be even
+        static void rgbRowsToYuv420(
+            const uint8_t* rgb0,
+            const uint8_t* rgb1,
+            const G2dRgbLayout& layout,
+            uint8_t* y0,
+            uint8_t* y1,
+            uint8_t* u,
+            uint8_t* v,
+            size_t width
+        );
+
+        /// @brief Converts an RGB row to BT.601 limited range YUV 4:2:2
+        /// Chroma is computed from the average of each pair of pixels.
+        /// @param rgb Source row
+        /// @param layout Pixel layout of the source row
+        /// @param y Destination luma row of width bytes
+        /// @param u Destination U row of width / 2 bytes
+        /// @param v Destination V row of width / 2 bytes
+        /// @param width Width of the row in pixels, must be even
+        static void rgbRowToYuv422(const uint8_t* rgb, const G2dRgbLayout& layout, uint8_t* y, uint8_t* u, uint8_t* v, size_t width);
+
+        /// @brief Computes the BT.601 limited range luma of an RGB row
+        /// @param rgb Source row
+        /// @param layout Pixel layout of the source row
+        /// @param y Destination luma row of width bytes
+        /// @param width Width of the row in pixels
+        static void rgbRowToLuma(const uint8_t* rgb, const G2dRgbLayout& layout, uint8_t* y, size_t width);
+
+        /// @brief Converts a row of RGB pixels to another RGB layout
+        /// Alpha is kept when both layouts carry it and set to opaque otherwise. Unused bytes are set to 0xFF.
+        /// Channels are expanded to 8 bits by bit replication and narrowed by truncation.
+        /// @param src Source row
+        /// @param srcLayout Pixel layout of the source row
+        /// @param dest Destination row, may be the same as src if both layouts have the same pixel size
+        /// @param destLayout Pixel layout of the destination row
+        /// @param width Width of the row in pixels
+        static void repackRgbRow(const uint8_t* src, const G2dRgbLayout& srcLayout, uint8_t* dest, const G2dRgbLayout& destLayout, size_t width);
+
+        /// @brief Blends a row of RGBA8888 overlay pixels over a row of RGB pixels
+        /// The overlay alpha is scaled by globalAlpha. Destinations with alpha get the combined coverage
+        /// of both, unused bytes are set to 0xFF.
+        /// @param overlay Overlay row, R, G, B and A bytes per pixel with straight alpha
+        /// @param globalAlpha Opacity applied to the whole row, 255 for none
+        /// @param dest Destination row
+        /// @param destLayout Pixel layout of the destination row
+        /// @param width Width of the row in pixels
+        static void blendRgbaRow(const uint8_t* overlay, uint8_t globalAlpha, uint8_t* dest, const G2dRgbLayout& destLayout, size_t width);
+
+        /// @brief Blends the BT.601 limited range luma of a row of RGBA8888 overlay pixels over luma samples
+        /// @param overlay Overlay row, R, G, B and A bytes per pixel with straight alpha
+        /// @param globalAlpha Opacity applied to the whole row, 255 for none
+        /// @param y First destination luma sample
+        /// @param step Distance between two luma samples in bytes, 1 for luma planes and 2 for packed 4:2:2 rows
+        /// @param width Width of the row in pixels
+        static void blendRgbaRowIntoLuma(const uint8_t* overlay, uint8_t globalAlpha, uint8_t* y, size_t step, size_t width);
+
+        /// @brief Blends the BT.601 limited range chroma of a block of RGBA8888 overlay pixels over one U and V sample
+        /// Each chroma sample covers up to 2x2 pixels. Covered pixels outside the overlay are passed as nullptr and
+        /// count as transparent.
+        /// @param pixels Overlay pixels covered by the chroma sample, R, G, B and A bytes each, or nullptr
+        /// @param count Number of pixels covered by the chroma sample, 2 for 4:2:2 and 4 for 4:2:0
+        /// @param globalAlpha Opacity applied to the whole overlay, 255 for none
+        /// @param u Destination U sample
+        /// @param v Destination V sample
+        static void blendRgbaIntoChroma(const uint8_t* const* pixels, size_t count, uint8_t globalAlpha, uint8_t* u, uint8_t* v);
+};
@@ -7,6 +7,7 @@
 #include "formats.hpp"
 
 #include "G2dFormatMetadata.hpp"
+#include "G2dFrameLayout.hpp"
 
 enum class FormatManagerStatus {
     SUCCESS = 0,
@@ -22,11 +23,32 @@ class G2dFormatManager {
         /// @return Optional containing OrqaG2dFormat if found, empty optional otherwise
         static std::optional<OrqaG2dFormat> getFormatEnumFromString(const std::string& formatStr);
 
+        /// @brief Gets the format string of an OrqaG2dFormat enum
+        /// @param format OrqaG2dFormat enum value
+        /// @return Optional containing the format string (e.g., "RGB565", "NV12") if found, empty optional otherwise
+        static std::optional<std::string> getFormatString(OrqaG2dFormat format);
+
         /// @brief Gets the G2D format and bits-per-pixel from an OrqaG2dFormat enum
         /// @param format OrqaG2dFormat enum value
         /// @return Optional containing G2dFormatMetadata if found, empty optional otherwise
         static std::optional<G2dFormatMetadata> getFormatMetadata(OrqaG2dFormat format);
 
+        /// @brief Calculates the size of a raw frame in bytes
+        /// @param format OrqaG2dFormat enum value
+        /// @param width Width of the frame in pixels
+        /// @param height Height of the frame in pixels
+        /// @return Optional containing the frame size in bytes if the format is known, empty optional if it is
+        /// not or the size does not fit in size_t
+        static std::optional<size_t> getFrameSize(OrqaG2dFormat format, size_t width, size_t height);
+
+        /// @brief Describes the planes of a raw frame
+        /// @param format OrqaG2dFormat enum value
+        /// @param width Width of the frame in pixels
+        /// @param height Height of the frame in pixels
+        /// @return Optional containing G2dFrameLayout if the format is known, empty optional if it is
+        /// not or the frame size does not fit in size_t
+        static std::optional<G2dFrameLayout> getFrameLayout(OrqaG2dFormat format, size_t width, size_t height);
+
         /// @brief Checks if conversion between two formats is supported
         /// @param srcFormat Source G2D format
         /// @param destFormat Destination G2D format
@@ -16,9 +16,14 @@ struct G2dFormatMetadata
     /// @details Used for buffer size calculations and format conversions
     size_t bpp; // bits per pixel
 
+    /// @brief The G2D hardware can read and write this format
+    /// @details Formats only the CPU produces have no G2D equivalent, their format field is a placeholder
+    bool deviceSupported;
+
     /// @brief Constructor for G2dFormatMetadata
     /// @param format The G2D format enumeration value
     /// @param bpp Number of bits per pixel for this format
-    G2dFormatMetadata(g2d_format format, size_t bpp)
-        : format(format), bpp(bpp) {}
+    /// @param deviceSupported The G2D hardware can read and write this format
+    G2dFormatMetadata(g2d_format format, size_t bpp, bool deviceSupported = true)
+        : format(format), bpp(bpp), deviceSupported(deviceSupported) {}
 };
\ No newline at end of file
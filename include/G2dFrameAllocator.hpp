@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief How large frame allocations are backed by huge pages
+enum class G2dHugePagePolicy {
+    /// @brief Regular pages only
+    NONE = 0,
+    /// @brief 2 MiB aligned memory, marked for transparent huge pages with madvise
+    TRANSPARENT,
+    /// @brief Memory from the explicit huge page pool (MAP_HUGETLB), falling back to TRANSPARENT when the pool is empty
+    EXPLICIT,
+};
+
+/// @brief Raw memory for frame buffers
+/// Every block is aligned to at least Alignment bytes. Blocks of HugePageSize bytes or
+/// more are mapped directly from the kernel, so they start out zeroed by the kernel
+/// and can be backed by huge pages according to the process wide huge page policy.
+class G2dFrameMemory {
+    public:
+        G2dFrameMemory() = delete;
+
+        /// @brief Alignment of every block, wide enough for any SIMD load and a full cache line
+        static constexpr size_t Alignment = 64;
+
+        /// @brief Size of a huge page, and the smallest block mapped directly from the kernel
+        static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+        /// @brief Allocates a block of memory
+        /// @param bytes Size of the block in bytes
+        /// @return Pointer to the block, throws std::bad_alloc on failure
+        static void* allocate(size_t bytes);
+
+        /// @brief Frees a block obtained from allocate()
+        /// @param block Pointer to the block
+        /// @param bytes Size the block was allocated with
+        static void deallocate(void* block, size_t bytes);
+
+        /// @brief Sets the huge page policy for later allocations
+        /// @param policy Huge page policy, G2dHugePagePolicy::TRANSPARENT by default
+        static void setHugePagePolicy(G2dHugePagePolicy policy);
+
+        /// @brief Gets the current huge page policy
+        static G2dHugePagePolicy hugePagePolicy();
+};
+
+/// @brief Standard allocator for frame buffers
+/// Memory comes from G2dFrameMemory. Elements are default-initialized, so resizing
+/// a buffer of bytes does not zero memory that is about to be overwritten anyway.
+template<typename T>
+class G2dFrameAllocator {
+    public:
+        using value_type = T;
+
+        G2dFrameAllocator() noexcept = default;
+
+        template<typename U>
+        G2dFrameAllocator(const G2dFrameAllocator<U>&) noexcept {}
+
+        T* allocate(size_t count) {
+            return static_cast<T*>(G2dFrameMemory::allocate(count * sizeof(T)));
+        }
+
+        void deallocate(T* block, size_t count) noexcept {
+            G2dFrameMemory::deallocate(block, count * sizeof(T));
+        }
+
+        template<typename U>
+        void construct(U* element) noexcept(std::is_nothrow_default_constructible_v<U>) {
+            ::new(static_cast<void*>(element)) U;
+        }
+
+        template<typename U, typename... Args>
+        void construct(U* element, Args&&... args) {
+            ::new(static_cast<void*>(element)) U(std::forward<Args>(args)...);
+        }
+
+        template<typename U>
+        bool operator==(const G2dFrameAllocator<U>&) const noexcept {
+            return true;
+        }
+};
+
+/// @brief Aligned, non-zeroing byte buffer for frames
+using G2dFrameBuffer = std::vector<uint8_t, G2dFrameAllocator<uint8_t>>;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+/// @brief Fast non-cryptographic hashing of frame data
+class G2dFrameHash {
+    public:
+        G2dFrameHash() = delete;
+
+        /// @brief Computes the 64 bit xxHash (XXH64) of a buffer
+        /// Four independent accumulators are updated per 32 byte stripe, so the
+        /// multiplications of consecutive stripes overlap in the pipeline.
+        /// @param data Bytes to hash
+        /// @param seed Hash seed
+        /// @return The XXH64 digest of the data
+        static uint64_t hash64(std::span<const uint8_t> data, uint64_t seed = 0);
+};
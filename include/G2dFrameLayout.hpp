@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/// @brief Memory layout of a single plane of a raw frame
+struct G2dPlaneLayout {
+    /// @brief Offset of the plane from the start of the frame in bytes
+    size_t offset = 0;
+
+    /// @brief Distance between the starts of two consecutive plane rows in bytes
+    size_t stride = 0;
+
+    /// @brief Number of rows in the plane
+    size_t rows = 0;
+
+    /// @brief Plane bits per image pixel, horizontally
+    /// @details The plane bytes of image columns [x0, x1) are [x0 * bpp / 8, x1 * bpp / 8) for even x0 and x1
+    size_t bpp = 0;
+
+    /// @brief Number of image rows covered by one plane row
+    size_t verticalSubsampling = 1;
+};
+
+/// @brief Memory layout of a raw frame, split into its planes
+struct G2dFrameLayout {
+    /// @brief Number of valid entries in planes
+    size_t planeCount = 0;
+
+    /// @brief Planes of the frame, in memory order
+    std::array<G2dPlaneLayout, 3> planes {};
+
+    /// @brief Total size of the frame in bytes
+    size_t frameSize = 0;
+};
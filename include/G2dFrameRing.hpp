@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "G2dSharedFrame.hpp"
+
+enum class G2dFrameRingStatus {
+    SUCCESS = 0,
+    ALLOCATION_ERROR = -1,
+    MAPPING_ERROR = -2,
+    TIMEOUT = -3,
+    CLOSED = -4,
+    WAIT_ERROR = -5,
+};
+
+struct G2dFrameRingHeader;
+
+/// @brief Single-producer single-consumer ring of fixed size frame slots in shared memory
+/// The slots live in a memfd mapped by both processes, so frames are written and read in place.
+/// Head and tail indices are atomics in the same memory. Handing over a frame only moves an index,
+/// an eventfd is written only when the other side is blocked waiting for it.
+/// The three descriptors returned by fds() can be passed to another process over a Unix domain socket,
+/// which attaches to the same ring. One process produces into the ring and one consumes from it.
+class G2dFrameRing {
+    public:
+        G2dFrameRing() = default;
+        ~G2dFrameRing();
+
+        G2dFrameRing(const G2dFrameRing&) = delete;
+        G2dFrameRing& operator=(const G2dFrameRing&) = delete;
+        G2dFrameRing(G2dFrameRing&& other) noexcept;
+        G2dFrameRing& operator=(G2dFrameRing&& other) noexcept;
+
+        /// @brief Creates a new ring in shared memory
+        /// @param slotSize Size of a frame slot in bytes
+        /// @param slotCount Number of frame slots
+        /// @return G2dFrameRingStatus::SUCCESS on success, one of the errors defined in G2dFrameRingStatus on failure
+        G2dFrameRingStatus create(size_t slotSize, size_t slotCount);
+
+        /// @brief Attaches to a ring created by another process. Takes ownership of the descriptors
+        /// @param memoryFd Shared memory file of the ring
+        /// @param dataEventFd Event signalled when a frame is published
+        /// @param spaceEventFd Event signalled when a slot is released
+        /// @return G2dFrameRingStatus::SUCCESS on success, G2dFrameRingStatus::MAPPING_ERROR on failure
+        G2dFrameRingStatus attach(int memoryFd, int dataEventFd, int spaceEventFd);
+
+        /// @brief Unmaps the ring and closes its descriptors
+        void release();
+
+        /// @brief Gets the descriptors to pass to another process: shared memory, data event and space event
+        std::array<int, 3> fds() const;
+
+        /// @brief Gets the size of a frame slot in bytes
+        size_t slotSize() const;
+
+        /// @brief Gets the number of frame slots
+        size_t slotCount() const;
+
+        /// @brief Waits for a free slot to write the next frame into. Producer only
+        /// @param slot Set to the free slot on success. Stays valid until commitWrite()
+        /// @param timeoutMs Longest time to wait in milliseconds, 0 to return immediately, -1 to wait forever
+        /// @return G2dFrameRingStatus::SUCCESS on success, G2dFrameRingStatus::TIMEOUT if the ring stayed full,
+        /// G2dFrameRingStatus::CLOSED if the ring was closed
+        G2dFrameRingStatus acquireWrite(std::span<uint8_t>& slot, int timeoutMs = -1);
+
+        /// @brief Publishes the slot returned by acquireWrite() to the consumer. Producer only
+        void commitWrite();
+
+        /// @brief Waits for the next published frame. Consumer only
+        /// @param slot Set to the frame on success. Stays valid until releaseRead() and may be modified in place
+        /// @param timeoutMs Longest time to wait in milliseconds, 0 to return immediately, -1 to wait forever
+        /// @return G2dFrameRingStatus::SUCCESS on success, G2dFrameRingStatus::TIMEOUT if no frame was published,
+        /// G2dFrameRingStatus::CLOSED if the ring was closed and all of its frames were read
+        G2dFrameRingStatus acquireRead(std::span<uint8_t>& slot, int timeoutMs = -1);
+
+        /// @brief Returns the slot returned by acquireRead() to the producer. Consumer only
+        void releaseRead();
+
+        /// @brief Marks the end of the stream and wakes up both sides
+        /// Frames already published can still be read.
+        void close();
+
+    private:
+        /// @brief Layout of the frame slots in the ring memory
+        struct SlotGeometry {
+            size_t size = 0;
+            size_t count = 0;
+            size_t stride = 0;
+            size_t offset = 0;
+        };
+
+        G2dFrameRingStatus map(G2dSharedFrame&& memory, const SlotGeometry& slots, int dataEventFd, int spaceEventFd);
+        uint8_t* slotData(uint64_t index);
+
+        G2dSharedFrame mMemory;
+        G2dFrameRingHeader* mHeader = nullptr;
+
+        /// @brief Slot layout, copied out of the shared header once it is validated. The other process
+        /// can write the header at any time, so the layout is never read from it again
+        SlotGeometry mSlots;
+        int mDataEventFd = -1;
+        int mSpaceEventFd = -1;
+
+        // Local copies of the indices, so the fast path only touches the other side's cache line when needed
+        uint64_t mWriteIndex = 0;
+        uint64_t mReadIndex = 0;
+        uint64_t mCachedReadIndex = 0;
+        uint64_t mCachedWriteIndex = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+#include "G2dFrameRing.hpp"
+#include "G2dPixelFormatConverter.hpp"
+
+enum class G2dFrameRingConverterStatus {
+    SUCCESS = 0,
+    TIMEOUT = -1,
+    CLOSED = -2,
+    RING_ERROR = -3,
+    SLOT_SIZE_ERROR = -4,
+    CONVERSION_ERROR = -5,
+};
+
+/// @brief Pipeline stage that converts frames from one frame ring into another
+/// Each frame is converted straight from its input slot into a free output slot, so no
+/// intermediate buffer is involved. The rings may be shared with the processes capturing
+/// and consuming the frames.
+class G2dFrameRingConverter {
+    public:
+        /// @brief Constructor for G2dFrameRingConverter
+        /// @param srcFormat Format of the frames in the input ring
+        /// @param destFormat Format of the frames written to the output ring
+        /// @param width Width of the frames in pixels
+        /// @param height Height of the frames in pixels
+        G2dFrameRingConverter(OrqaG2dFormat srcFormat, OrqaG2dFormat destFormat, size_t width, size_t height);
+
+        /// @brief Gets the converter used by the stage, to select its backend or tuning
+        G2dPixelFormatConverter& converter();
+
+        /// @brief Converts the next frame of the input ring into the output ring
+        /// If no output slot frees up in time, the input frame is kept and converted by the next call.
+        /// A frame that fails to convert is dropped.
+        /// @param input Ring to consume frames from
+        /// @param output Ring to produce frames into
+        /// @param timeoutMs Longest time to wait for each ring in milliseconds, -1 to wait forever
+        /// @return G2dFrameRingConverterStatus::SUCCESS on success, G2dFrameRingConverterStatus::CLOSED
+        /// once either ring is closed, one of the errors defined in G2dFrameRingConverterStatus on failure
+        G2dFrameRingConverterStatus convertNext(G2dFrameRing& input, G2dFrameRing& output, int timeoutMs = -1);
+
+        /// @brief Converts frames until the input ring is closed, then closes the output ring
+        /// @param input Ring to consume frames from
+        /// @param output Ring to produce frames into
+        /// @return G2dFrameRingConverterStatus::SUCCESS when the input ends, one of the errors defined
+        /// in G2dFrameRingConverterStatus if the stage had to stop early
+        G2dFrameRingConverterStatus run(G2dFrameRing& input, G2dFrameRing& output);
+
+    private:
+        G2dPixelFormatConverter mConverter;
+        OrqaG2dFormat mSrcFormat;
+        OrqaG2dFormat mDestFormat;
+        size_t mWidth;
+        size_t mHeight;
+        size_t mSrcFrameSize;
+        size_t mDestFrameSize;
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "G2dPixelFormatConverter.hpp"
+#include "formats.hpp"
+
+enum class G2dFrameSchedulerStatus {
+    SUCCESS = 0,
+    INVALID_STREAM_ERROR = -1,
+    QUEUE_FULL_ERROR = -2,
+};
+
+/// @brief What a stream does with a frame submitted while its queue is full
+enum class G2dOverflowPolicy {
+    /// @brief The oldest queued frame is dropped to make room, so the stream always converts its newest frames
+    DROP_OLDEST = 0,
+    /// @brief The new frame is refused and submit() returns G2dFrameSchedulerStatus::QUEUE_FULL_ERROR
+    DROP_NEWEST,
+};
+
+/// @brief How a scheduled frame ended
+enum class G2dFrameOutcome {
+    /// @brief Converted before its deadline
+    CONVERTED = 0,
+    /// @brief Converted, but finished after its deadline
+    CONVERTED_LATE,
+    /// @brief The conversion failed, see the conversion status
+    FAILED,
+    /// @brief Dropped unconverted, the deadline had passed or could not be met any more
+    DROPPED_STALE,
+    /// @brief Dropped unconverted to make room for a newer frame of the same stream
+    DROPPED_OVERFLOW,
+};
+
+/// @brief Result of a scheduled frame, passed to its completion callback
+struct G2dScheduledFrameResult {
+    G2dFrameOutcome outcome;
+
+    /// @brief Status of the conversion, G2dPixelFormatConverterStatus::SUCCESS for dropped frames
+    G2dPixelFormatConverterStatus status;
+
+    /// @brief Time from submission until the frame was converted or dropped
+    std::chrono::steady_clock::duration latency;
+};
+
+/// @brief Scheduling parameters of a stream
+struct G2dStreamOptions {
+    /// @brief Frames of streams with a higher priority are converted first
+    int priority = 0;
+
+    /// @brief Most frames the stream may have waiting for a worker, at least 1
+    size_t queueDepth = 2;
+
+    /// @brief What happens to a frame submitted while the queue is full
+    G2dOverflowPolicy overflowPolicy = G2dOverflowPolicy::DROP_OLDEST;
+};
+
+/// @brief Counters of a stream
+struct G2dStreamStats {
+    uint64_t submitted = 0;
+    uint64_t converted = 0;
+
+    /// @brief Frames converted after their deadline, also counted in converted
+    uint64_t late = 0;
+    uint64_t failed = 0;
+    uint64_t droppedStale = 0;
+
+    /// @brief Frames dropped or refused because the queue was full
+    uint64_t droppedOverflow = 0;
+
+    /// @brief Frames waiting for a worker right now
+    size_t queueDepth = 0;
+
+    /// @brief Most frames that have been waiting at the same time
+    size_t peakQueueDepth = 0;
+};
+
+/// @brief Deadline aware scheduler for live frame streams
+/// Every frame carries a deadline and belongs to a stream with a priority and a bounded queue,
+/// so an overloaded scheduler sheds frames instead of building up latency. Workers always take
+/// the head frame of the highest priority stream, and the earliest deadline among streams of
+/// the same priority. Frames that can no longer finish in time, judged by the recent conversion
+/// time of their stream, are dropped before any work is spent on them.
+/// Every accepted frame ends with exactly one call of its completion callback, after which its
+/// buffers are free to reuse.
+class G2dFrameScheduler {
+    public:
+        /// @brief Called once a frame is converted or dropped
+        /// Called on a worker thread, or on the submitting thread for frames dropped by submit()
+        using CompletionCallback = std::function<void(const G2dScheduledFrameResult&)>;
+
+        /// @brief Constructor for G2dFrameScheduler
+        /// @param workerCount Number of worker threads, each with its own device session
+        explicit G2dFrameScheduler(size_t workerCount = 1);
+
+        /// @brief Finishes or drops all queued frames and stops the workers
+        ~G2dFrameScheduler();
+
+        G2dFrameScheduler(const G2dFrameScheduler&) = delete;
+        G2dFrameScheduler& operator=(const G2dFrameScheduler&) = delete;
+        G2dFrameScheduler(G2dFrameScheduler&&) = delete;
+        G2dFrameScheduler& operator=(G2dFrameScheduler&&) = delete;
+
+        /// @brief Adds a stream of frames
+        /// @param options Scheduling parameters of the stream
+        /// @return Identifier of the stream, passed to submit() and stats()
+        size_t addStream(const G2dStreamOptions& options = {});
+
+        /// @brief Submits a frame of a stream
+        /// Both buffers must stay alive and untouched until the callback is called.
+        /// The conversion parameters are the same as for G2dPixelFormatConverter::convertImage()
+        /// @param stream Stream returned by addStream()
+        /// @param deadline Time by which the frame is of use, it is dropped if it cannot be converted by then
+        /// @param callback Called once the frame is converted or dropped
+        /// @return G2dFrameSchedulerStatus::SUCCESS if the frame was accepted, one of the errors
+        /// defined in G2dFrameSchedulerStatus otherwise, in which case the callback is never called
+        G2dFrameSchedulerStatus submit(
+            size_t stream,
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const std::vector<uint8_t>& srcBuffer,
+            std::vector<uint8_t>& destBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            std::chrono::steady_clock::time_point deadline,
+            CompletionCallback callback
+        );
+
+        /// @brief Gets the counters of a stream
+        /// @param stream Stream returned by addStream()
+        /// @return The counters, or an empty optional if the stream does not exist
+        std::optional<G2dStreamStats> stats(size_t stream) const;
+
+        /// @brief Gets the number of worker threads
+        size_t workerCount() const;
+
+    private:
+        /// @brief A submitted frame waiting for a worker
+        struct Frame {
+            OrqaG2dFormat srcFormat = OrqaG2dFormat::FMT_RGB565;
+            OrqaG2dFormat destFormat = OrqaG2dFormat::FMT_RGB565;
+            const std::vector<uint8_t>* srcBuffer = nullptr;
+            std::vector<uint8_t>* destBuffer = nullptr;
+            size_t srcWidth = 0;
+            size_t srcHeight = 0;
+            size_t destWidth = 0;
+            size_t destHeight = 0;
+            std::chrono::steady_clock::time_point submitted;
+            std::chrono::steady_clock::time_point deadline;
+            CompletionCallback callback;
+        };
+
+        struct Stream {
+            G2dStreamOptions options;
+            std::deque<Frame> queue;
+            G2dStreamStats stats;
+
+            /// @brief Moving average of the conversion time of the stream's frames
+            std::chrono::steady_clock::duration conversionTime {};
+        };
+
+        /// @brief A frame leaving the scheduler unconverted, reported once the lock is released
+        struct DroppedFrame {
+            Frame frame;
+            G2dFrameOutcome outcome;
+        };
+
+        static bool isStale(const Stream& stream, const Frame& frame, std::chrono::steady_clock::time_point now);
+        std::optional<Frame> takeNextFrame(std::vector<DroppedFrame>& dropped, size_t& stream);
+        static void reportDropped(std::vector<DroppedFrame>& dropped);
+        void runWorker();
+
+        mutable std::mutex mMutex;
+        std::condition_variable mWake;
+        std::vector<Stream> mStreams;
+        size_t mQueuedFrames = 0;
+        bool mStopping = false;
+        std::vector<std::thread> mWorkers;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <g2d.h>
+#include <cstdint>
+#include <span>
+
+#include "G2dBufferPool.hpp"
+#include "G2dFrameAllocator.hpp"
+#include "G2dFrameLayout.hpp"
+#include "G2dPixelFormatConverter.hpp"
+#include "formats.hpp"
+
+/// @brief A converter for video feeds that mostly change in small areas
+/// The converter keeps the previous source frame and the converted output. Every new
+/// frame is compared to the previous one tile by tile, and only the tiles that changed
+/// are uploaded, blitted and copied back into the persistent output. For mostly static
+/// scenes the work scales with the changed area instead of the frame size.
+/// The converter opens the accelerator on the first frame and keeps it open for the whole feed.
+class G2dIncrementalConverter {
+    public:
+        /// @brief Constructor for G2dIncrementalConverter
+        /// @param tileWidth Width of the compared tiles in pixels, rounded up to an even number
+        /// @param tileHeight Height of the compared tiles in pixels, rounded up to an even number
+        explicit G2dIncrementalConverter(size_t tileWidth = 64, size_t tileHeight = 16);
+        ~G2dIncrementalConverter();
+
+        G2dIncrementalConverter(const G2dIncrementalConverter&) = delete;
+        G2dIncrementalConverter& operator=(const G2dIncrementalConverter&) = delete;
+        G2dIncrementalConverter(G2dIncrementalConverter&&) = delete;
+        G2dIncrementalConverter& operator=(G2dIncrementalConverter&&) = delete;
+
+        /// @brief Converts the next frame of a feed, reconverting only the tiles that changed
+        /// The whole frame is converted when the formats or the size change, and for the first frame.
+        /// The source and the output have the same size.
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param srcBuffer Source image data
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus convertFrame(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            std::span<const uint8_t> srcBuffer,
+            size_t width,
+            size_t height
+        );
+
+        /// @brief Gets the converted output of the last frame
+        std::span<const uint8_t> output() const;
+
+        /// @brief Gets the number of tiles reconverted for the last frame
+        size_t lastDirtyTileCount() const;
+
+        /// @brief Gets the number of tiles in a frame
+        size_t tileCount() const;
+
+        /// @brief Forgets the previous frame, so the next frame is converted in full
+        /// The accelerator stays open
+        void reset();
+
+    private:
+        /// @brief A rectangle of image pixels, [x0, x1) x [y0, y1)
+        struct Rect {
+            size_t x0;
+            size_t y0;
+            size_t x1;
+            size_t y1;
+        };
+
+        G2dPixelFormatConverterStatus convertFull(std::span<const uint8_t> srcBuffer);
+        G2dPixelFormatConverterStatus convertDirtyTiles(std::span<const uint8_t> srcBuffer);
+        G2dPixelFormatConverterStatus openDevice();
+        void releaseBuffers();
+
+        static bool regionChanged(const G2dFrameLayout& layout, const uint8_t* current, const uint8_t* previous, const Rect& rect);
+        static void copyRegion(const G2dFrameLayout& layout, const uint8_t* from, uint8_t* to, const Rect& rect);
+        static g2d_surface clipSurface(const g2d_surface& surface, const Rect& rect, size_t width, size_t height);
+
+        size_t mTileWidth;
+        size_t mTileHeight;
+
+        bool mHasFrame = false;
+        OrqaG2dFormat mSrcFormat = OrqaG2dFormat::FMT_RGB565;
+        OrqaG2dFormat mDestFormat = OrqaG2dFormat::FMT_RGB565;
+        size_t mWidth = 0;
+        size_t mHeight = 0;
+        G2dFrameLayout mSrcLayout;
+        G2dFrameLayout mDestLayout;
+
+        G2dFrameBuffer mPreviousSource;
+        G2dFrameBuffer mOutput;
+        size_t mLastDirtyTiles = 0;
+
+        /// @brief Device handle, nullptr until the first frame is converted
+        void* mHandle = nullptr;
+        G2dBufferPool mBufferPool;
+
+        /// @brief DMA buffers kept for the whole feed, holding the last source and output
+        g2d_buf* mSrcG2dBuf = nullptr;
+        g2d_buf* mDestG2dBuf = nullptr;
+        g2d_surface mSrcSurface {};
+        g2d_surface mDestSurface {};
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "G2dCpuConverter.hpp"
+#include "G2dFrameAllocator.hpp"
+#include "formats.hpp"
+
+enum class G2dLumaPyramidStatus {
+    SUCCESS = 0,
+    UNSUPPORTED_FORMAT_ERROR = -1,
+    BUFFER_SIZE_ERROR = -2,
+};
+
+/// @brief One level of a luma pyramid, an 8 bit gray image with contiguous rows
+struct G2dLumaPyramidLevel {
+    /// @brief Luma samples of the level, width bytes per row
+    std::span<const uint8_t> pixels;
+
+    /// @brief Width of the level in pixels
+    size_t width;
+
+    /// @brief Height of the level in pixels
+    size_t height;
+};
+
+/// @brief Luma pyramid of a frame, for vision pipelines that only look at brightness
+/// Level 0 is the luma of the frame at full size, every further level halves the one before it
+/// with a 2x2 box filter. When the frame keeps its luma in a plane of its own (NV12, NV21, NV16,
+/// NV61, I420, YV12 or GRAY8), level 0 points straight into the source buffer and nothing is copied.
+/// Other formats have their luma extracted first, the packed 4:2:2 ones by picking out their luma bytes.
+/// The memory of the levels is kept between builds, so building a pyramid of every frame of a stream
+/// does not allocate once the first frame is done.
+class G2dLumaPyramid {
+    public:
+        /// @brief Builds the pyramid of a frame, replacing the previous levels
+        /// Levels stay valid until the next build. A level 0 pointing into the source also needs
+        /// the source buffer to stay alive.
+        /// @param srcFormat Format of the frame, a YUV or RGB format or GRAY8
+        /// @param srcBuffer Frame data
+        /// @param width Width of the frame in pixels
+        /// @param height Height of the frame in pixels
+        /// @param levelCount Number of levels to build including level 0. Fewer are built when a level
+        /// would shrink to nothing, odd rows and columns are dropped when halving
+        /// @param options Threading of the luma extraction, when level 0 cannot point into the source
+        /// @return G2dLumaPyramidStatus::SUCCESS on success, one of the errors defined
+        /// in G2dLumaPyramidStatus on failure
+        G2dLumaPyramidStatus build(
+            OrqaG2dFormat srcFormat,
+            std::span<const uint8_t> srcBuffer,
+            size_t width,
+            size_t height,
+            size_t levelCount,
+            const G2dCpuConversionOptions& options = {}
+        );
+
+        /// @brief Gets the number of levels of the last build
+        size_t levelCount() const;
+
+        /// @brief Gets a level of the pyramid
+        /// @param index Level index, 0 for full size, must be less than levelCount()
+        const G2dLumaPyramidLevel& level(size_t index) const;
+
+    private:
+        std::vector<G2dLumaPyramidLevel> mLevels;
+        G2dFrameBuffer mStorage;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+
+/// @brief Lock-free intrusive multi-producer single-consumer queue
+/// Based on Dmitry Vyukov's MPSC node queue. push() is wait-free and can be called
+/// from any number of threads, pop() must only be called from a single consumer thread.
+/// Queued nodes are not owned by the queue. T must provide a `std::atomic<T*> next` member
+/// and be default constructible, as the queue keeps one T as its stub node.
+template <typename T>
+class G2dMpscQueue {
+    public:
+        G2dMpscQueue() {
+            mStub.next.store(nullptr, std::memory_order_relaxed);
+        }
+
+        G2dMpscQueue(const G2dMpscQueue&) = delete;
+        G2dMpscQueue& operator=(const G2dMpscQueue&) = delete;
+        G2dMpscQueue(G2dMpscQueue&&) = delete;
+        G2dMpscQueue& operator=(G2dMpscQueue&&) = delete;
+        ~G2dMpscQueue() = default;
+
+        /// @brief Appends a node to the queue. Safe to call from any thread
+        /// @param node Node to append. Must stay alive until it is popped
+        void push(T* node) {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            T* prev = mHead.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        /// @brief Removes the oldest node from the queue. Consumer thread only
+        /// @return The oldest node, or nullptr if the queue is empty or a producer
+        /// is in the middle of a push. In the latter case the caller should retry
+        T* pop() {
+            T* tail = mTail;
+            T* next = tail->next.load(std::memory_order_acquire);
+
+            if(tail == &mStub) {
+                if(next == nullptr) {
+                    return nullptr;
+                }
+                mTail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if(next != nullptr) {
+                mTail = next;
+                return tail;
+            }
+
+            if(tail != mHead.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+
+            push(&mStub);
+            next = tail->next.load(std::memory_order_acquire);
+            if(next != nullptr) {
+                mTail = next;
+                return tail;
+            }
+            return nullptr;
+        }
+
+    private:
+        T mStub {};
+        alignas(64) std::atomic<T*> mHead = &mStub;
+        alignas(64) T* mTail = &mStub;
+};
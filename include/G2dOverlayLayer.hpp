@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// @brief An RGBA8888 image blended on top of a converted frame, such as an on screen display
+struct G2dOverlayLayer {
+    /// @brief Overlay pixels, R, G, B and A bytes per pixel with straight alpha, row after row without padding
+    std::span<const uint8_t> pixels;
+
+    /// @brief Width of the overlay in pixels
+    size_t width;
+
+    /// @brief Height of the overlay in pixels
+    size_t height;
+
+    /// @brief Column of the converted frame the left edge of the overlay is placed at
+    size_t left;
+
+    /// @brief Row of the converted frame the top edge of the overlay is placed at
+    size_t top;
+
+    /// @brief Opacity applied to the whole overlay on top of its per pixel alpha, 255 for fully opaque
+    uint8_t globalAlpha = 255;
+};
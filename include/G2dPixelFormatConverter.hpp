@@ -2,8 +2,18 @@
 
 #include <g2d.h>
 #include <optional>
+#include <span>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "G2dFormatMetadata.hpp"
+#include "G2dBufferPool.hpp"
+#include "G2dConversionCache.hpp"
+#include "G2dConversionOutput.hpp"
+#include "G2dOverlayLayer.hpp"
+#include "G2dCpuConverter.hpp"
+#include "G2dFrameAllocator.hpp"
 #include "formats.hpp"
 
 enum class G2dPixelFormatConverterStatus {
@@ -18,21 +28,94 @@ enum class G2dPixelFormatConverterStatus {
     MEMORY_DEALLOCATION_ERROR = -8,
     INVALID_FORMAT_ERROR = -9,
     UNSUPPORTED_CONVERSION_ERROR = -10,
+    BUFFER_SIZE_ERROR = -11,
+    MEMORY_ALLOCATION_ERROR = -12,
+    CONNECTION_ERROR = -13,
+};
+
+class G2dTuningTable;
+
+/// @brief Selects where conversions run
+enum class G2dConversionBackend {
+    /// @brief Conversions that have a CPU kernel run on the CPU, all others on the accelerator
+    AUTO = 0,
+    /// @brief All conversions run on the accelerator
+    DEVICE,
+    /// @brief All conversions run on the CPU, conversions without a CPU kernel fail
+    CPU,
 };
 
 /// @brief A class that handles pixel format conversion using GPU acceleration
 /// This class provides functionality to convert between various pixel formats
-/// including RGB and YUV color spaces using the G2D hardware accelerator
+/// including RGB and YUV color spaces using the G2D hardware accelerator.
+/// By default every conversion opens and closes the device on its own. Long running
+/// users can open a session, which keeps the device handle and the DMA buffers
+/// alive between conversions.
 class G2dPixelFormatConverter {
     private:
+        /// @brief Optional cache of recent conversion results, nullptr when disabled
+        std::unique_ptr<G2dConversionCache> mResultCache;
+
+        G2dConversionBackend mBackend = G2dConversionBackend::AUTO;
+        G2dCpuConversionOptions mCpuOptions;
+
+        /// @brief Measured best configurations, consulted by G2dConversionBackend::AUTO, nullptr when not set
+        std::shared_ptr<const G2dTuningTable> mTuningTable;
+
+        /// @brief Gets the backend a conversion runs on, applying the tuning table to G2dConversionBackend::AUTO
+        /// @param cpuOptions Set to the CPU threading to use for the conversion
+        G2dConversionBackend resolveBackend(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            G2dCpuConversionOptions& cpuOptions
+        ) const;
+
+        /// @brief Device handle of the open session, nullptr if no session is open
+        void* mHandle = nullptr;
+
+        /// @brief DMA buffers reused between conversions
+        G2dBufferPool mBufferPool;
+
+        /// @brief Blends overlay layers over a destination surface on the device
+        /// The blits are queued after the conversion blit, so the converted frame never leaves
+        /// the device before the overlays are applied. Returns without waiting for the device.
+        /// @param destSurface Destination surface of the conversion
+        /// @param destWidth Width of the destination image in pixels
+        /// @param destHeight Height of the destination image in pixels
+        /// @param overlays Layers to blend, bottom layer first
+        /// @param overlayBuffers Filled with the DMA buffers holding the overlays, to release once the device is done
+        /// @return G2dPixelFormatConverterStatus::SUCCESS on success, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus blitOverlays(
+            const struct g2d_surface& destSurface,
+            size_t destWidth,
+            size_t destHeight,
+            std::span<const G2dOverlayLayer> overlays,
+            std::vector<g2d_buf*>& overlayBuffers
+        );
+
+    public:
+        G2dPixelFormatConverter() = default;
+        ~G2dPixelFormatConverter();
+
+        G2dPixelFormatConverter(const G2dPixelFormatConverter&) = delete;
+        G2dPixelFormatConverter& operator=(const G2dPixelFormatConverter&) = delete;
+        G2dPixelFormatConverter(G2dPixelFormatConverter&&) = delete;
+        G2dPixelFormatConverter& operator=(G2dPixelFormatConverter&&) = delete;
+
         /// @brief Configures the source surface for G2D operations
+        /// Also used by other classes that drive the accelerator themselves, like G2dIncrementalConverter
         /// @param format G2D format enumeration for the source
         /// @param surface Reference to the G2D surface structure to be configured
         /// @param buf Pointer to the G2D buffer containing source data
         /// @param width Width of the image in pixels
         /// @param height Height of the image in pixels
         /// @return G2dPixelFormatConverterStatus::SUCCESS on success, G2dPixelFormatConverterStatus::UNSUPPORTED_SOURCE_FORMAT_ERROR on failure
-        G2dPixelFormatConverterStatus setSourceFormatSurface(
+        static G2dPixelFormatConverterStatus setSourceFormatSurface(
             g2d_format format,
             struct g2d_surface& surface,
             g2d_buf* buf,
@@ -47,7 +130,7 @@ class G2dPixelFormatConverter {
         /// @param width Width of the image in pixels
         /// @param height Height of the image in pixels
         /// @return G2dPixelFormatConverterStatus::SUCCESS on success, G2dPixelFormatConverterStatus::UNSUPPORTED_DESTINATION_FORMAT_ERROR on failure
-        G2dPixelFormatConverterStatus setDestinationFormatSurface(
+        static G2dPixelFormatConverterStatus setDestinationFormatSurface(
             g2d_format format,
             struct g2d_surface& surface,
             g2d_buf* buf,
@@ -55,7 +138,52 @@ class G2dPixelFormatConverter {
             int height
         );
 
-    public:        
+        /// @brief Opens the video accelerator and keeps it open until closeSession() is called
+        /// @return G2dPixelFormatConverterStatus::SUCCESS on success, G2dPixelFormatConverterStatus::DEVICE_ERROR on failure
+        G2dPixelFormatConverterStatus openSession();
+
+        /// @brief Closes the video accelerator and frees all pooled DMA buffers
+        /// @return G2dPixelFormatConverterStatus::SUCCESS on success, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus closeSession();
+
+        /// @brief Checks if a device session is currently open
+        bool isSessionOpen() const;
+
+        /// @brief Enables caching of conversion results
+        /// Converting a frame that is byte-identical to a recently converted one, with the
+        /// same parameters, returns the cached result without touching the device.
+        /// @param maxBytes Maximum memory used by cached results
+        void enableResultCache(size_t maxBytes);
+
+        /// @brief Disables caching of conversion results and frees the cached results
+        void disableResultCache();
+
+        /// @brief Gets the statistics of the result cache
+        /// @return Optional containing the cache statistics if the cache is enabled, empty optional otherwise
+        std::optional<G2dConversionCacheStats> resultCacheStats() const;
+
+        /// @brief Selects where conversions run
+        /// Memory bound conversions, like repacking one YUV layout into another, are faster on the
+        /// CPU than a round trip through the accelerator. The CPU kernels keep the image size, so
+        /// scaling conversions always run on the accelerator.
+        /// @param backend Backend to use, G2dConversionBackend::AUTO by default
+        void setConversionBackend(G2dConversionBackend backend);
+
+        /// @brief Gets the selected conversion backend
+        G2dConversionBackend conversionBackend() const;
+
+        /// @brief Sets how conversions running on the CPU are split across threads
+        /// @param options Threading options, a single thread by default
+        void setCpuConversionOptions(const G2dCpuConversionOptions& options);
+
+        /// @brief Sets the measured best configurations to use with G2dConversionBackend::AUTO
+        /// Tuned conversions run on the backend, and with the CPU threading, stored in the table.
+        /// Conversions missing from the table keep the default behaviour. The table may be shared
+        /// between converters.
+        /// @param table Table filled by G2dAutotuner or loaded from a tuning file, nullptr to stop using it
+        void setTuningTable(std::shared_ptr<const G2dTuningTable> table);
+
         /// @brief Converts an image from one pixel format to another using G2D hardware
         /// @param srcFormat String representation of source format (e.g., "RGB565", "NV12")
         /// @param destFormat String representation of destination format
@@ -65,6 +193,7 @@ class G2dPixelFormatConverter {
         /// @param srcHeight Height of the source image in pixels
         /// @param destWidth Width of the destination image in pixels
         /// @param destHeight Height of the destination image in pixels
+        /// @param overlays RGBA layers blended on top of the converted image, bottom layer first
         /// @return SUCCESS on successful conversion, one of the errors defined
         /// in G2dPixelFormatConverterStatus on failure
         G2dPixelFormatConverterStatus convertImage(
@@ -75,6 +204,101 @@ class G2dPixelFormatConverter {
             size_t srcWidth,
             size_t srcHeight,
             size_t destWidth,
-            size_t destHeight
+            size_t destHeight,
+            std::span<const G2dOverlayLayer> overlays = {}
+        );
+
+        /// @brief Converts an image between aligned frame buffers
+        /// Same as the std::vector overload, but the destination is resized without being zeroed first.
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param srcBuffer Source image data
+        /// @param destBuffer Buffer to store converted image data (will be resized as needed)
+        /// @param srcWidth Width of the source image in pixels
+        /// @param srcHeight Height of the source image in pixels
+        /// @param destWidth Width of the destination image in pixels
+        /// @param destHeight Height of the destination image in pixels
+        /// @param overlays RGBA layers blended on top of the converted image, bottom layer first
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            const G2dFrameBuffer& srcBuffer,
+            G2dFrameBuffer& destBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            std::span<const G2dOverlayLayer> overlays = {}
+        );
+
+        /// @brief Converts an image in place, for format pairs that keep the frame size
+        /// Reordering packed YUV samples (YUYV, YVYU, UYVY, VYUY), swapping the chroma order
+        /// (NV12 and NV21, NV16 and NV61, I420 and YV12) and converting between RGB formats with
+        /// the same pixel size (for example RGBA8888 and BGRA8888) need no second buffer.
+        /// The conversion always runs on the CPU and does not use the result cache.
+        /// @param srcFormat Format of the image in the buffer
+        /// @param destFormat Format to convert the image to
+        /// @param buffer Image data, overwritten with the converted image
+        /// @param width Width of the image in pixels
+        /// @param height Height of the image in pixels
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus convertImageInPlace(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            std::span<uint8_t> buffer,
+            size_t width,
+            size_t height
         );
-};
\ No newline at end of file
+
+        /// @brief Converts an image stored in caller owned memory
+        /// Overlays are blended in the same pass as the conversion: on the accelerator with G2D blending
+        /// before the frame is read back, on the CPU into each band of rows right after it is converted.
+        /// The accelerator does not blend into YUV destinations, so there only the overlaid rectangles are
+        /// blended on the CPU after the read back. Conversions with overlays bypass the result cache.
+        /// @param srcFormat Source image format
+        /// @param destFormat Destination image format
+        /// @param srcBuffer Source image data
+        /// @param destBuffer Memory to store the converted image in. Must be large enough to hold the destination frame
+        /// @param srcWidth Width of the source image in pixels
+        /// @param srcHeight Height of the source image in pixels
+        /// @param destWidth Width of the destination image in pixels
+        /// @param destHeight Height of the destination image in pixels
+        /// @param overlays RGBA layers blended on top of the converted image, bottom layer first
+        /// @return SUCCESS on successful conversion, one of the errors defined
+        /// in G2dPixelFormatConverterStatus on failure
+        G2dPixelFormatConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            OrqaG2dFormat destFormat,
+            std::span<const uint8_t> srcBuffer,
+            std::span<uint8_t> destBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            size_t destWidth,
+            size_t destHeight,
+            std::span<const G2dOverlayLayer> overlays = {}
+        );
+
+        /// @brief Converts one source image into several outputs of different formats and sizes
+        /// The source is read once for all outputs. Outputs converted on the accelerator share a
+        /// single upload of the source and are blitted back to back before waiting for the device,
+        /// while the outputs converted on the CPU are produced in the meantime, fused into one
+        /// pass over the source. Each output may carry overlay layers, blended in the same pass.
+        /// The result cache is not used.
+        /// @param srcFormat Source image format
+        /// @param srcBuffer Source image data
+        /// @param srcWidth Width of the source image in pixels
+        /// @param srcHeight Height of the source image in pixels
+        /// @param outputs Destinations of the conversion
+        /// @return SUCCESS when every output was converted, the first error defined
+        /// in G2dPixelFormatConverterStatus otherwise
+        G2dPixelFormatConverterStatus convertImage(
+            OrqaG2dFormat srcFormat,
+            std::span<const uint8_t> srcBuffer,
+            size_t srcWidth,
+            size_t srcHeight,
+            std::span<const G2dConversionOutput> outputs
+        );
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+enum class G2dSharedFrameStatus {
+    SUCCESS = 0,
+    ALLOCATION_ERROR = -1,
+    MAPPING_ERROR = -2,
+};
+
+/// @brief A frame buffer backed by an anonymous shared memory file (memfd)
+/// The file descriptor of the frame can be passed to another process over a
+/// Unix domain socket, which maps the same memory instead of copying the pixel data.
+class G2dSharedFrame {
+    public:
+        G2dSharedFrame() = default;
+        ~G2dSharedFrame();
+
+        G2dSharedFrame(const G2dSharedFrame&) = delete;
+        G2dSharedFrame& operator=(const G2dSharedFrame&) = delete;
+        G2dSharedFrame(G2dSharedFrame&& other) noexcept;
+        G2dSharedFrame& operator=(G2dSharedFrame&& other) noexcept;
+
+        /// @brief Creates a new shared memory file of the given size and maps it
+        /// The file is sealed with F_SEAL_SHRINK, so processes it is passed to can map it safely
+        /// @param size Size of the frame in bytes
+        /// @return G2dSharedFrameStatus::SUCCESS on success, one of the errors defined in G2dSharedFrameStatus on failure
+        G2dSharedFrameStatus allocate(size_t size);
+
+        /// @brief Maps a shared memory file received from another process. Takes ownership of the descriptor
+        /// Files that are not sealed with F_SEAL_SHRINK are refused, since the sender could shrink them under the mapping
+        /// @param fd File descriptor of the shared memory file
+        /// @param size Number of bytes to map
+        /// @param writable Map the memory for writing as well as reading
+        /// @return G2dSharedFrameStatus::SUCCESS on success, G2dSharedFrameStatus::MAPPING_ERROR on failure
+        G2dSharedFrameStatus attach(int fd, size_t size, bool writable);
+
+        /// @brief Unmaps the frame and closes its file descriptor
+        void release();
+
+        /// @brief Gets the file descriptor of the shared memory file, -1 if the frame is empty
+        int fd() const;
+
+        /// @brief Gets the size of the mapped frame in bytes
+        size_t size() const;
+
+        /// @brief Gets a pointer to the mapped frame memory
+        uint8_t* data();
+        const uint8_t* data() const;
+
+        /// @brief Gets a view of the mapped frame memory
+        std::span<uint8_t> span();
+        std::span<const uint8_t> span() const;
+
+    private:
+        int mFd = -1;
+        size_t mSize = 0;
+        uint8_t* mData = nullptr;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "G2dCpuConverter.hpp"
+#include "G2dPixelFormatConverter.hpp"
+#include "formats.hpp"
+
+enum class G2dTuningStatus {
+    SUCCESS = 0,
+    FILE_ERROR = -1,
+    PARSE_ERROR = -2,
+    CALIBRATION_ERROR = -3,
+};
+
+/// @brief A same-size conversion the tuning applies to
+struct G2dTuningKey {
+    OrqaG2dFormat srcFormat;
+    OrqaG2dFormat destFormat;
+    size_t width;
+    size_t height;
+
+    bool operator==(const G2dTuningKey& other) const = default;
+};
+
+/// @brief The fastest measured configuration of a conversion
+struct G2dTunedConfiguration {
+    /// @brief G2dConversionBackend::DEVICE or G2dConversionBackend::CPU
+    G2dConversionBackend backend = G2dConversionBackend::DEVICE;
+
+    /// @brief Threading of the conversion when it runs on the CPU
+    G2dCpuConversionOptions cpuOptions;
+
+    /// @brief Measured time of one conversion in microseconds
+    double microseconds = 0.0;
+};
+
+/// @brief Measured best configurations per conversion, stored in a tuning file
+/// The tuning file is plain text with one conversion per line:
+/// source and destination format, width, height, backend, CPU threads, CPU band rows
+/// and the measured time in microseconds. Lines starting with '#' are comments.
+class G2dTuningTable {
+    public:
+        /// @brief Finds the configuration of a conversion
+        /// @param key Conversion to look up
+        /// @return Optional containing the configuration if the conversion was tuned, empty optional otherwise
+        std::optional<G2dTunedConfiguration> find(const G2dTuningKey& key) const;
+
+        /// @brief Stores the configuration of a conversion, replacing any previous one
+        /// @param key Conversion the configuration applies to
+        /// @param configuration Configuration to store
+        void set(const G2dTuningKey& key, const G2dTunedConfiguration& configuration);
+
+        /// @brief Gets the number of tuned conversions
+        size_t size() const;
+
+        /// @brief Writes the table to a tuning file
+        /// @param path Path of the tuning file
+        /// @return G2dTuningStatus::SUCCESS on success, G2dTuningStatus::FILE_ERROR if the file could not be written
+        G2dTuningStatus save(const std::string& path) const;
+
+        /// @brief Reads a tuning file, adding its entries to the table
+        /// @param path Path of the tuning file
+        /// @return G2dTuningStatus::SUCCESS on success, G2dTuningStatus::FILE_ERROR if the file could not be read,
+        /// G2dTuningStatus::PARSE_ERROR if a line is malformed
+        G2dTuningStatus load(const std::string& path);
+
+    private:
+        std::vector<std::pair<G2dTuningKey, G2dTunedConfiguration>> mEntries;
+};
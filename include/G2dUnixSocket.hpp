@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class G2dUnixSocketStatus {
+    SUCCESS = 0,
+    SOCKET_ERROR = -1,
+    SEND_ERROR = -2,
+    RECEIVE_ERROR = -3,
+    CONNECTION_CLOSED = -4,
+    WOULD_BLOCK = -5,
+};
+
+/// @brief Helpers for Unix domain stream sockets that carry file descriptors
+/// Messages are fixed size structures, with any file descriptors passed
+/// alongside them as SCM_RIGHTS ancillary data.
+class G2dUnixSocket {
+    public:
+        G2dUnixSocket() = delete;
+
+        /// @brief Maximum number of file descriptors sent with a single message
+        static constexpr size_t MaxFds = 4;
+
+        /// @brief Creates a listening socket bound to the given path, replacing any stale socket file
+        /// @param path Filesystem path of the socket
+        /// @param fd Set to the listening socket descriptor on success
+        /// @return G2dUnixSocketStatus::SUCCESS on success, G2dUnixSocketStatus::SOCKET_ERROR on failure
+        static G2dUnixSocketStatus listenOn(const std::string& path, int& fd);
+
+        /// @brief Connects to a listening socket
+        /// @param path Filesystem path of the socket
+        /// @param fd Set to the connected socket descriptor on success
+        /// @return G2dUnixSocketStatus::SUCCESS on success, G2dUnixSocketStatus::SOCKET_ERROR on failure
+        static G2dUnixSocketStatus connectTo(const std::string& path, int& fd);
+
+        /// @brief Sends a message together with file descriptors
+        /// @param socketFd Connected socket
+        /// @param data Message bytes
+        /// @param fds Descriptors to pass to the peer, at most MaxFds
+        /// @return G2dUnixSocketStatus::SUCCESS on success, G2dUnixSocketStatus::SEND_ERROR on failure
+        static G2dUnixSocketStatus sendMessage(
+            int socketFd,
+            std::span<const std::byte> data,
+            std::span<const int> fds
+        );
+
+        /// @brief Receives a message of exactly data.size() bytes and any file descriptors sent with it
+        /// @param socketFd Connected socket
+        /// @param data Buffer to receive the message into
+        /// @param fds Filled with the received descriptors. The caller owns them
+        /// @return G2dUnixSocketStatus::SUCCESS on success, G2dUnixSocketStatus::CONNECTION_CLOSED if the
+        /// peer closed the connection, G2dUnixSocketStatus::RECEIVE_ERROR on failure
+        static G2dUnixSocketStatus receiveMessage(
+            int socketFd,
+            std::span<std::byte> data,
+            std::vector<int>& fds
+        );
+
+        /// @brief Receives as much of a message as a non-blocking socket has available, without waiting
+        /// Call it again with the same arguments once the socket is readable to continue the message.
+        /// @param socketFd Connected non-blocking socket
+        /// @param data Buffer to receive the message into
+        /// @param received Number of bytes of the message received so far, updated on return
+        /// @param fds Received descriptors are appended to it. The caller owns them
+        /// @return G2dUnixSocketStatus::SUCCESS once the whole message is received, G2dUnixSocketStatus::WOULD_BLOCK
+        /// if more data is to come, G2dUnixSocketStatus::CONNECTION_CLOSED if the peer closed the connection,
+        /// G2dUnixSocketStatus::RECEIVE_ERROR on failure
+        static G2dUnixSocketStatus receiveAvailable(
+            int socketFd,
+            std::span<std::byte> data,
+            size_t& received,
+            std::vector<int>& fds
+        );
+};
@@ -26,6 +26,8 @@ enum class OrqaG2dFormat {
     FMT_VYUY,
     FMT_NV16,
     FMT_NV61,
+    FMT_BGRA8888,
+    FMT_GRAY8,
 };
 
 static const std::unordered_map<std::string, OrqaG2dFormat> OrqaFormatLookup = {
@@ -48,6 +50,8 @@ static const std::unordered_map<std::string, OrqaG2dFormat> OrqaFormatLookup = {
     {"VYUY", OrqaG2dFormat::FMT_VYUY},
     {"NV16", OrqaG2dFormat::FMT_NV16},
     {"NV61", OrqaG2dFormat::FMT_NV61},
+    {"BGRA8888", OrqaG2dFormat::FMT_BGRA8888},
+    {"GRAY8", OrqaG2dFormat::FMT_GRAY8},
 };
 
 /// @brief Mapping of format strings to their corresponding G2D format and bits per pixel
@@ -71,6 +75,9 @@ static const std::unordered_map<OrqaG2dFormat, G2dFormatMetadata> OrqaToG2DForma
     {OrqaG2dFormat::FMT_VYUY, {G2D_VYUY, 16}},
     {OrqaG2dFormat::FMT_NV16, {G2D_NV16, 16}},
     {OrqaG2dFormat::FMT_NV61, {G2D_NV61, 16}},
+    {OrqaG2dFormat::FMT_BGRA8888, {G2D_BGRA8888, 32}},
+    // 8 bit luma only, produced on the CPU. G2D has no such format, so the luma plane of NV12 stands in
+    {OrqaG2dFormat::FMT_GRAY8, {G2D_NV12, 8, false}},
 };
 
 /// @brief List of supported format conversion pairs. 
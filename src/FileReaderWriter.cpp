@@ -21,9 +21,10 @@ FileReaderWriterStatus FileReaderWriter::writeFileRaw (
     return FileReaderWriterStatus::SUCCESS;
 }
 
-FileReaderWriterStatus FileReaderWriter::readFileRaw (
+template<typename Buffer>
+FileReaderWriterStatus FileReaderWriter::readFileInto (
     const std::string& filename, 
-    std::vector<uint8_t>& buffer
+    Buffer& buffer
 ) {
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
@@ -45,4 +46,18 @@ FileReaderWriterStatus FileReaderWriter::readFileRaw (
     file.close();
 
     return FileReaderWriterStatus::SUCCESS;
+}
+
+FileReaderWriterStatus FileReaderWriter::readFileRaw (
+    const std::string& filename, 
+    std::vector<uint8_t>& buffer
+) {
+    return readFileInto(filename, buffer);
+}
+
+FileReaderWriterStatus FileReaderWriter::readFileRaw (
+    const std::string& filename, 
+    G2dFrameBuffer& buffer
+) {
+    return readFileInto(filename, buffer);
 }
\ No newline at end of file
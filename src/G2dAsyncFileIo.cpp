@@ -0,0 +1,262 @@
+#include "G2dAsyncFileIo.hpp"
+#include "FileReaderWriter.hpp"
+
+#include <utility>
+
+#ifdef G2D_WITH_IO_URING
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#endif
+
+G2dAsyncFileIo::G2dAsyncFileIo(size_t threadCount, [[maybe_unused]] unsigned queueDepth) {
+#ifdef G2D_WITH_IO_URING
+    if(io_uring_queue_init(queueDepth, &mRing, 0) == 0) {
+        mWakeFd = eventfd(0, EFD_CLOEXEC);
+        if(mWakeFd >= 0) {
+            mBackend = G2dAsyncFileIoBackend::IO_URING;
+            mThreads.emplace_back(&G2dAsyncFileIo::runRing, this);
+            return;
+        }
+        io_uring_queue_exit(&mRing);
+    }
+    std::cerr << "io_uring is not available, falling back to blocking I/O threads" << "\n";
+#endif
+
+    const size_t count = threadCount == 0 ? 1 : threadCount;
+    for(size_t i = 0; i < count; i++) {
+        mThreads.emplace_back(&G2dAsyncFileIo::runThreadPool, this);
+    }
+}
+
+G2dAsyncFileIo::~G2dAsyncFileIo() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mCondition.notify_all();
+
+#ifdef G2D_WITH_IO_URING
+    if(mBackend == G2dAsyncFileIoBackend::IO_URING) {
+        const uint64_t value = 1;
+        [[maybe_unused]] const ssize_t written = ::write(mWakeFd, &value, sizeof(value));
+    }
+#endif
+
+    for(std::thread& thread : mThreads) {
+        thread.join();
+    }
+
+#ifdef G2D_WITH_IO_URING
+    if(mBackend == G2dAsyncFileIoBackend::IO_URING) {
+        io_uring_queue_exit(&mRing);
+        close(mWakeFd);
+    }
+#endif
+}
+
+void G2dAsyncFileIo::read(const std::string& path, std::vector<uint8_t>& buffer, Completion completion) {
+    Request request;
+    request.path = path;
+    request.readBuffer = &buffer;
+    request.completion = std::move(completion);
+    enqueue(std::move(request));
+}
+
+void G2dAsyncFileIo::write(const std::string& path, std::span<const uint8_t> buffer, Completion completion) {
+    Request request;
+    request.isWrite = true;
+    request.path = path;
+    request.writeBuffer = buffer;
+    request.completion = std::move(completion);
+    enqueue(std::move(request));
+}
+
+G2dAsyncFileIoBackend G2dAsyncFileIo::backend() const {
+    return mBackend;
+}
+
+void G2dAsyncFileIo::enqueue(Request request) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRequests.push_back(std::move(request));
+    }
+
+#ifdef G2D_WITH_IO_URING
+    if(mBackend == G2dAsyncFileIoBackend::IO_URING) {
+        const uint64_t value = 1;
+        [[maybe_unused]] const ssize_t written = ::write(mWakeFd, &value, sizeof(value));
+        return;
+    }
+#endif
+    mCondition.notify_one();
+}
+
+void G2dAsyncFileIo::runThreadPool() {
+    while(true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mStopping || !mRequests.empty(); });
+            if(mRequests.empty()) {
+                return;
+            }
+            request = std::move(mRequests.front());
+            mRequests.pop_front();
+        }
+
+        const bool success = serveBlocking(request);
+        if(request.completion) {
+            request.completion(success);
+        }
+    }
+}
+
+bool G2dAsyncFileIo::serveBlocking(Request& request) {
+    FileReaderWriter fileReaderWriter;
+    if(request.isWrite) {
+        return fileReaderWriter.writeFileRaw(request.path, request.writeBuffer) == FileReaderWriterStatus::SUCCESS;
+    }
+    return fileReaderWriter.readFileRaw(request.path, *request.readBuffer) == FileReaderWriterStatus::SUCCESS;
+}
+
+#ifdef G2D_WITH_IO_URING
+void G2dAsyncFileIo::runRing() {
+    // the eventfd is polled through the ring itself, so new requests and finished
+    // transfers are both picked up by a single io_uring_submit_and_wait() call
+    auto armWakeUp = [this]() {
+        io_uring_sqe* sqe = io_uring_get_sqe(&mRing);
+        if(sqe == nullptr) {
+            io_uring_submit(&mRing);
+            sqe = io_uring_get_sqe(&mRing);
+        }
+        io_uring_prep_poll_add(sqe, mWakeFd, POLLIN);
+        io_uring_sqe_set_data(sqe, nullptr);
+    };
+
+    auto finish = [](Request* request, bool success) {
+        if(request->fd >= 0) {
+            close(request->fd);
+        }
+        if(request->completion) {
+            request->completion(success);
+        }
+        delete request;
+    };
+
+    std::deque<Request*> backlog;
+    const size_t maxInFlight = mRing.sq.ring_entries - 1;
+    bool stopping = false;
+    armWakeUp();
+
+    while(!stopping || !backlog.empty() || mInFlight != 0) {
+        while(!backlog.empty() && mInFlight < maxInFlight) {
+            Request* request = backlog.front();
+            backlog.pop_front();
+            if(!submitRing(request)) {
+                finish(request, false);
+            }
+        }
+
+        io_uring_submit_and_wait(&mRing, 1);
+
+        io_uring_cqe* cqe = nullptr;
+        while(io_uring_peek_cqe(&mRing, &cqe) == 0) {
+            auto* request = static_cast<Request*>(io_uring_cqe_get_data(cqe));
+            const int result = cqe->res;
+            io_uring_cqe_seen(&mRing, cqe);
+
+            if(request == nullptr) {
+                uint64_t value = 0;
+                [[maybe_unused]] const ssize_t readBytes = ::read(mWakeFd, &value, sizeof(value));
+
+                std::deque<Request> requests;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    requests.swap(mRequests);
+                    stopping = mStopping;
+                }
+                for(Request& queued : requests) {
+                    backlog.push_back(new Request(std::move(queued)));
+                }
+                if(!stopping) {
+                    armWakeUp();
+                }
+                continue;
+            }
+
+            mInFlight--;
+            const size_t total = request->isWrite ? request->writeBuffer.size() : request->readBuffer->size();
+            if(result < 0 || (result == 0 && request->done < total)) {
+                std::cerr << "Failed to " << (request->isWrite ? "write " : "read ") << request->path << "\n";
+                finish(request, false);
+                continue;
+            }
+
+            request->done += static_cast<size_t>(result);
+            if(request->done < total) {
+                // short transfer, queue the rest
+                backlog.push_front(request);
+            }
+            else {
+                finish(request, true);
+            }
+        }
+    }
+}
+
+bool G2dAsyncFileIo::submitRing(Request* request) {
+    if(request->fd < 0) {
+        if(request->isWrite) {
+            request->fd = open(request->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        }
+        else {
+            request->fd = open(request->path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat fileStat {};
+            if(request->fd >= 0 && fstat(request->fd, &fileStat) == 0) {
+                request->readBuffer->clear();
+                request->readBuffer->resize(static_cast<size_t>(fileStat.st_size));
+            }
+        }
+        if(request->fd < 0) {
+            std::cerr << "Failed to open file: " << request->path << "\n";
+            return false;
+        }
+    }
+
+    const size_t total = request->isWrite ? request->writeBuffer.size() : request->readBuffer->size();
+    if(request->done >= total) {
+        // nothing to transfer, complete through the ring to keep the completion order simple
+        io_uring_sqe* sqe = io_uring_get_sqe(&mRing);
+        if(sqe == nullptr) {
+            io_uring_submit(&mRing);
+            sqe = io_uring_get_sqe(&mRing);
+        }
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, request);
+        mInFlight++;
+        return true;
+    }
+
+    io_uring_sqe* sqe = io_uring_get_sqe(&mRing);
+    if(sqe == nullptr) {
+        io_uring_submit(&mRing);
+        sqe = io_uring_get_sqe(&mRing);
+    }
+
+    const auto length = static_cast<unsigned>(std::min<size_t>(total - request->done, 1U << 30U));
+    if(request->isWrite) {
+        io_uring_prep_write(sqe, request->fd, request->writeBuffer.data() + request->done, length, request->done);
+    }
+    else {
+        io_uring_prep_read(sqe, request->fd, request->readBuffer->data() + request->done, length, request->done);
+    }
+    io_uring_sqe_set_data(sqe, request);
+    mInFlight++;
+    return true;
+}
+#endif
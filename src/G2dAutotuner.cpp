@@ -0,0 +1,151 @@
+#include "G2dAutotuner.hpp"
+#include "G2dFormatManager.hpp"
+#include "G2dFrameAllocator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <thread>
+
+namespace {
+
+/// @brief Times a conversion, returning the median duration in microseconds
+/// The conversion is run once untimed first, so caches, pools and pages are warm.
+template<typename Convert>
+std::optional<double> measure(size_t iterations, const Convert& convert) {
+    if(!convert()) {
+        return {};
+    }
+
+    std::vector<double> durations;
+    durations.reserve(iterations);
+    for(size_t i = 0; i < iterations; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        if(!convert()) {
+            return {};
+        }
+        const auto end = std::chrono::steady_clock::now();
+        durations.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    std::nth_element(durations.begin(), durations.begin() + static_cast<std::ptrdiff_t>(durations.size() / 2), durations.end());
+    return durations[durations.size() / 2];
+}
+
+}
+
+G2dAutotuner::G2dAutotuner(size_t iterations, size_t maxThreads)
+    : mIterations(std::max<size_t>(1, iterations)),
+      mMaxThreads(maxThreads != 0 ? maxThreads : std::max<unsigned>(1, std::thread::hardware_concurrency())) {}
+
+G2dTuningStatus G2dAutotuner::calibrate(const std::vector<G2dTuningKey>& keys, G2dTuningTable& table) const {
+    G2dTuningStatus status = G2dTuningStatus::SUCCESS;
+    std::mt19937 generator(0x6d2d);
+
+    for(const G2dTuningKey& key : keys) {
+        std::optional<size_t> srcSize = G2dFormatManager::getFrameSize(key.srcFormat, key.width, key.height);
+        std::optional<size_t> destSize = G2dFormatManager::getFrameSize(key.destFormat, key.width, key.height);
+        if(!srcSize.has_value() || !destSize.has_value()) {
+            std::cerr << "Invalid format in tuning request" << "\n";
+            status = G2dTuningStatus::CALIBRATION_ERROR;
+            continue;
+        }
+
+        // random content, so no stage can take a shortcut on uniform data
+        G2dFrameBuffer srcFrame(*srcSize);
+        G2dFrameBuffer destFrame(*destSize);
+        std::generate(srcFrame.begin(), srcFrame.end(), [&]() { return static_cast<uint8_t>(generator()); });
+
+        std::optional<G2dTunedConfiguration> best;
+        auto consider = [&](const G2dTunedConfiguration& candidate) {
+            if(!best.has_value() || candidate.microseconds < best->microseconds) {
+                best = candidate;
+            }
+        };
+
+        {
+            G2dPixelFormatConverter converter;
+            converter.setConversionBackend(G2dConversionBackend::DEVICE);
+            if(converter.openSession() == G2dPixelFormatConverterStatus::SUCCESS) {
+                std::optional<double> microseconds = measure(mIterations, [&]() {
+                    return converter.convertImage(
+                        key.srcFormat,
+                        key.destFormat,
+                        std::span<const uint8_t>(srcFrame),
+                        std::span<uint8_t>(destFrame),
+                        key.width,
+                        key.height,
+                        key.width,
+                        key.height
+                    ) == G2dPixelFormatConverterStatus::SUCCESS;
+                });
+                if(microseconds.has_value()) {
+                    consider({G2dConversionBackend::DEVICE, {}, *microseconds});
+                }
+            }
+        }
+
+        if(G2dCpuConverter::isConversionSupported(key.srcFormat, key.destFormat, key.width, key.height)) {
+            for(size_t threads = 1; threads <= mMaxThreads; threads *= 2) {
+                for(size_t bandRows : {size_t {0}, size_t {16}, size_t {64}}) {
+                    // a single thread works through the frame in one go either way
+                    if(threads == 1 && bandRows != 0) {
+                        continue;
+                    }
+
+                    const G2dCpuConversionOptions options {threads, bandRows};
+                    std::optional<double> microseconds = measure(mIterations, [&]() {
+                        return G2dCpuConverter::convertImage(
+                            key.srcFormat,
+                            key.destFormat,
+                            srcFrame,
+                            destFrame,
+                            key.width,
+                            key.height,
+                            options
+                        ) == G2dCpuConverterStatus::SUCCESS;
+                    });
+                    if(microseconds.has_value()) {
+                        consider({G2dConversionBackend::CPU, options, *microseconds});
+                    }
+                }
+            }
+        }
+
+        if(!best.has_value()) {
+            std::cerr << "No configuration could run the conversion" << "\n";
+            status = G2dTuningStatus::CALIBRATION_ERROR;
+            continue;
+        }
+        table.set(key, *best);
+    }
+
+    return status;
+}
+
+G2dTuningStatus G2dAutotuner::loadOrCalibrate(
+    const std::string& path,
+    const std::vector<G2dTuningKey>& keys,
+    G2dTuningTable& table
+) const
+{
+    // a missing file just means nothing has been measured yet
+    const G2dTuningStatus loadStatus = table.load(path);
+    if(loadStatus == G2dTuningStatus::PARSE_ERROR) {
+        return loadStatus;
+    }
+
+    std::vector<G2dTuningKey> missing;
+    std::copy_if(keys.begin(), keys.end(), std::back_inserter(missing), [&](const G2dTuningKey& key) {
+        return !table.find(key).has_value();
+    });
+    if(missing.empty()) {
+        return G2dTuningStatus::SUCCESS;
+    }
+
+    const G2dTuningStatus calibrateStatus = calibrate(missing, table);
+    const G2dTuningStatus saveStatus = table.save(path);
+    return calibrateStatus != G2dTuningStatus::SUCCESS ? calibrateStatus : saveStatus;
+}
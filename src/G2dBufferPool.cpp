@@ -0,0 +1,65 @@
+#include "G2dBufferPool.hpp"
+#include "g2dEnums.hpp"
+
+#include <iostream>
+
+G2dBufferPool::G2dBufferPool(size_t maxIdleBuffers)
+    : mMaxIdleBuffers(maxIdleBuffers) {}
+
+G2dBufferPool::~G2dBufferPool() {
+    clear();
+}
+
+g2d_buf* G2dBufferPool::acquire(size_t size) {
+    // pick the smallest idle buffer that is large enough
+    auto best = mIdleBuffers.end();
+    for(auto it = mIdleBuffers.begin(); it != mIdleBuffers.end(); ++it) {
+        if(
+            static_cast<size_t>((*it)->buf_size) >= size &&
+            (best == mIdleBuffers.end() || (*it)->buf_size < (*best)->buf_size)
+        ) {
+            best = it;
+        }
+    }
+
+    if(best != mIdleBuffers.end()) {
+        g2d_buf* buf = *best;
+        mIdleBuffers.erase(best);
+        return buf;
+    }
+
+    g2d_buf* buf = g2d_alloc(
+        static_cast<int>(size),
+        static_cast<int>(G2dBufferCacheable::NON_CACHEABLE)
+    );
+    if(buf == nullptr) {
+        std::cerr << "Failed to allocate a G2D buffer of " << size << " bytes" << "\n";
+    }
+    return buf;
+}
+
+bool G2dBufferPool::release(g2d_buf* buf) {
+    if(buf == nullptr) {
+        return true;
+    }
+    if(mIdleBuffers.size() < mMaxIdleBuffers) {
+        mIdleBuffers.push_back(buf);
+        return true;
+    }
+    return g2d_free(buf) >= 0;
+}
+
+bool G2dBufferPool::clear() {
+    bool success = true;
+    for(g2d_buf* buf : mIdleBuffers) {
+        if(g2d_free(buf) < 0) {
+            success = false;
+        }
+    }
+    mIdleBuffers.clear();
+    return success;
+}
+
+size_t G2dBufferPool::idleBufferCount() const {
+    return mIdleBuffers.size();
+}
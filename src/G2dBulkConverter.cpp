@@ -0,0 +1,246 @@
+#include "G2dBulkConverter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+    /// @brief A frame moving through the read, convert and write stages
+    struct Slot {
+        size_t fileIndex = 0;
+        std::vector<uint8_t> srcBuffer;
+        std::vector<uint8_t> destBuffer;
+    };
+
+    /// @brief State of one bulk run
+    /// Every slot cycles through read -> convert -> write on its own. The completions
+    /// chain into each other, so the stages of different files overlap without a
+    /// coordinating thread.
+    class BulkRun {
+        public:
+            BulkRun(
+                G2dConcurrentConverter& converter,
+                G2dAsyncFileIo& fileIo,
+                const std::vector<std::string>& srcFiles,
+                std::vector<std::string> destFiles,
+                G2dBulkConversionSummary& summary
+            )
+                : mConverter(converter),
+                  mFileIo(fileIo),
+                  mSrcFiles(srcFiles),
+                  mDestFiles(std::move(destFiles)),
+                  mSummary(summary) {}
+
+            OrqaG2dFormat srcFormat = OrqaG2dFormat::FMT_RGB565;
+            OrqaG2dFormat destFormat = OrqaG2dFormat::FMT_RGB565;
+            size_t srcWidth = 0;
+            size_t srcHeight = 0;
+            size_t destWidth = 0;
+            size_t destHeight = 0;
+
+            /// @brief Runs the given slots until all files are done
+            void run(std::vector<std::unique_ptr<Slot>>& slots) {
+                mActiveSlots = slots.size();
+                for(auto& slot : slots) {
+                    startNext(*slot);
+                }
+
+                std::unique_lock<std::mutex> lock(mMutex);
+                mFinished.wait(lock, [this]() { return mActiveSlots == 0; });
+            }
+
+        private:
+            void startNext(Slot& slot) {
+                slot.fileIndex = mNextFile.fetch_add(1);
+                if(slot.fileIndex >= mSrcFiles.size()) {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if(--mActiveSlots == 0) {
+                        mFinished.notify_all();
+                    }
+                    return;
+                }
+
+                mFileIo.read(mSrcFiles[slot.fileIndex], slot.srcBuffer, [this, &slot](bool success) {
+                    onRead(slot, success);
+                });
+            }
+
+            void onRead(Slot& slot, bool success) {
+                if(!success) {
+                    finishFile(slot, false);
+                    return;
+                }
+
+                mConverter.submit(
+                    srcFormat,
+                    destFormat,
+                    slot.srcBuffer,
+                    slot.destBuffer,
+                    srcWidth,
+                    srcHeight,
+                    destWidth,
+                    destHeight,
+                    [this, &slot](G2dPixelFormatConverterStatus status) {
+                        onConverted(slot, status == G2dPixelFormatConverterStatus::SUCCESS);
+                    }
+                );
+            }
+
+            void onConverted(Slot& slot, bool success) {
+                if(!success) {
+                    finishFile(slot, false);
+                    return;
+                }
+
+                mFileIo.write(mDestFiles[slot.fileIndex], slot.destBuffer, [this, &slot](bool written) {
+                    finishFile(slot, written);
+                });
+            }
+
+            void finishFile(Slot& slot, bool success) {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if(success) {
+                        mSummary.converted++;
+                    }
+                    else {
+                        mSummary.failedFiles.push_back(mSrcFiles[slot.fileIndex]);
+                    }
+                }
+                startNext(slot);
+            }
+
+            G2dConcurrentConverter& mConverter;
+            G2dAsyncFileIo& mFileIo;
+            const std::vector<std::string>& mSrcFiles;
+            std::vector<std::string> mDestFiles;
+            G2dBulkConversionSummary& mSummary;
+
+            std::atomic<size_t> mNextFile = 0;
+            std::mutex mMutex;
+            std::condition_variable mFinished;
+            size_t mActiveSlots = 0;
+    };
+}
+
+G2dBulkConverter::G2dBulkConverter(size_t workerCount, size_t ioThreadCount, size_t maxInFlight)
+    : mMaxInFlight(maxInFlight == 0 ? 1 : maxInFlight),
+      mConverter(workerCount),
+      mFileIo(ioThreadCount) {}
+
+G2dBulkConverterStatus G2dBulkConverter::convertDirectory(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const std::string& srcDirectory,
+    const std::string& destDirectory,
+    const std::string& destExtension,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    G2dBulkConversionSummary& summary
+)
+{
+    std::vector<std::string> srcFiles;
+    std::error_code error;
+    for(const auto& entry : std::filesystem::directory_iterator(srcDirectory, error)) {
+        if(entry.is_regular_file()) {
+            srcFiles.push_back(entry.path().string());
+        }
+    }
+    if(error) {
+        std::cerr << "Failed to list directory: " << srcDirectory << "\n";
+        return G2dBulkConverterStatus::DIRECTORY_ERROR;
+    }
+    std::sort(srcFiles.begin(), srcFiles.end());
+
+    return convertFiles(
+        srcFormat,
+        destFormat,
+        srcFiles,
+        destDirectory,
+        destExtension,
+        srcWidth,
+        srcHeight,
+        destWidth,
+        destHeight,
+        summary
+    );
+}
+
+G2dBulkConverterStatus G2dBulkConverter::convertFiles(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const std::vector<std::string>& srcFiles,
+    const std::string& destDirectory,
+    const std::string& destExtension,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    G2dBulkConversionSummary& summary
+)
+{
+    summary = {};
+
+    std::error_code error;
+    std::filesystem::create_directories(destDirectory, error);
+    if(error) {
+        std::cerr << "Failed to create directory: " << destDirectory << "\n";
+        return G2dBulkConverterStatus::DIRECTORY_ERROR;
+    }
+
+    std::vector<std::string> destFiles;
+    destFiles.reserve(srcFiles.size());
+    for(const std::string& srcFile : srcFiles) {
+        std::filesystem::path destFile = std::filesystem::path(destDirectory) / std::filesystem::path(srcFile).stem();
+        destFile += "." + destExtension;
+        destFiles.push_back(destFile.lexically_normal().string());
+    }
+
+    // outputs are named after the source stem only, so two sources must not overwrite each other's output
+    std::unordered_map<std::string, size_t> firstSource;
+    for(size_t i = 0; i < destFiles.size(); i++) {
+        const auto [found, inserted] = firstSource.emplace(destFiles[i], i);
+        if(!inserted) {
+            std::cerr << "Source files " << srcFiles[found->second] << " and " << srcFiles[i]
+                << " would both be written to " << destFiles[i] << "\n";
+            if(summary.failedFiles.empty() || summary.failedFiles.back() != srcFiles[found->second]) {
+                summary.failedFiles.push_back(srcFiles[found->second]);
+            }
+            summary.failedFiles.push_back(srcFiles[i]);
+        }
+    }
+    if(!summary.failedFiles.empty()) {
+        return G2dBulkConverterStatus::DUPLICATE_OUTPUT_ERROR;
+    }
+
+    BulkRun run(mConverter, mFileIo, srcFiles, std::move(destFiles), summary);
+    run.srcFormat = srcFormat;
+    run.destFormat = destFormat;
+    run.srcWidth = srcWidth;
+    run.srcHeight = srcHeight;
+    run.destWidth = destWidth;
+    run.destHeight = destHeight;
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    const size_t slotCount = std::min(mMaxInFlight, srcFiles.size());
+    for(size_t i = 0; i < slotCount; i++) {
+        slots.push_back(std::make_unique<Slot>());
+    }
+    run.run(slots);
+
+    return summary.failedFiles.empty()
+        ? G2dBulkConverterStatus::SUCCESS
+        : G2dBulkConverterStatus::CONVERSION_ERROR;
+}
+
+G2dAsyncFileIoBackend G2dBulkConverter::ioBackend() const {
+    return mFileIo.backend();
+}
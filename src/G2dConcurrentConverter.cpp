@@ -0,0 +1,147 @@
+#include "G2dConcurrentConverter.hpp"
+
+G2dConcurrentConverter::G2dConcurrentConverter(size_t workerCount) {
+    const size_t count = workerCount == 0 ? 1 : workerCount;
+    mWorkers.reserve(count);
+    for(size_t i = 0; i < count; i++) {
+        mWorkers.push_back(std::make_unique<Worker>());
+    }
+    for(auto& worker : mWorkers) {
+        worker->thread = std::thread(runWorker, std::ref(*worker));
+    }
+}
+
+G2dConcurrentConverter::~G2dConcurrentConverter() {
+    for(auto& worker : mWorkers) {
+        worker->stopping.store(true, std::memory_order_release);
+        worker->signal.fetch_add(1, std::memory_order_release);
+        worker->signal.notify_one();
+    }
+    for(auto& worker : mWorkers) {
+        worker->thread.join();
+    }
+}
+
+std::future<G2dPixelFormatConverterStatus> G2dConcurrentConverter::submit(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const std::vector<uint8_t>& srcBuffer,
+    std::vector<uint8_t>& destBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight
+)
+{
+    auto* job = new Job;
+    job->srcFormat = srcFormat;
+    job->destFormat = destFormat;
+    job->srcBuffer = &srcBuffer;
+    job->destBuffer = &destBuffer;
+    job->srcWidth = srcWidth;
+    job->srcHeight = srcHeight;
+    job->destWidth = destWidth;
+    job->destHeight = destHeight;
+    job->promise.emplace();
+
+    std::future<G2dPixelFormatConverterStatus> future = job->promise->get_future();
+    enqueue(job);
+    return future;
+}
+
+void G2dConcurrentConverter::submit(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const std::vector<uint8_t>& srcBuffer,
+    std::vector<uint8_t>& destBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    CompletionCallback callback
+)
+{
+    auto* job = new Job;
+    job->srcFormat = srcFormat;
+    job->destFormat = destFormat;
+    job->srcBuffer = &srcBuffer;
+    job->destBuffer = &destBuffer;
+    job->srcWidth = srcWidth;
+    job->srcHeight = srcHeight;
+    job->destWidth = destWidth;
+    job->destHeight = destHeight;
+    job->callback = std::move(callback);
+
+    enqueue(job);
+}
+
+size_t G2dConcurrentConverter::workerCount() const {
+    return mWorkers.size();
+}
+
+void G2dConcurrentConverter::enqueue(Job* job) {
+    // every producer thread walks the workers from its own starting point,
+    // so producers share no counter and do not contend on a cache line
+    thread_local size_t producerCursor = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    // pick the less loaded of two neighbouring workers, so a slow job does not
+    // hold up the frames queued behind it while another worker is idle
+    const size_t first = producerCursor++ % mWorkers.size();
+    const size_t second = (first + 1) % mWorkers.size();
+    Worker& worker = mWorkers[second]->pending.load(std::memory_order_relaxed)
+        < mWorkers[first]->pending.load(std::memory_order_relaxed)
+        ? *mWorkers[second]
+        : *mWorkers[first];
+
+    // counted before the push, so the worker can never take the job before it is counted
+    worker.pending.fetch_add(1, std::memory_order_release);
+    worker.queue.push(job);
+    worker.signal.fetch_add(1, std::memory_order_release);
+    worker.signal.notify_one();
+}
+
+void G2dConcurrentConverter::runWorker(Worker& worker) {
+    G2dPixelFormatConverter converter;
+    converter.openSession();
+
+    while(true) {
+        const uint32_t signal = worker.signal.load(std::memory_order_acquire);
+        Job* job = worker.queue.pop();
+
+        if(job == nullptr) {
+            if(worker.pending.load(std::memory_order_acquire) != 0) {
+                // a producer is half way through a push
+                std::this_thread::yield();
+            }
+            else if(worker.stopping.load(std::memory_order_acquire)) {
+                break;
+            }
+            else {
+                worker.signal.wait(signal, std::memory_order_acquire);
+            }
+            continue;
+        }
+        worker.pending.fetch_sub(1, std::memory_order_relaxed);
+
+        const G2dPixelFormatConverterStatus status = converter.convertImage(
+            job->srcFormat,
+            job->destFormat,
+            *job->srcBuffer,
+            *job->destBuffer,
+            job->srcWidth,
+            job->srcHeight,
+            job->destWidth,
+            job->destHeight
+        );
+
+        if(job->promise.has_value()) {
+            job->promise->set_value(status);
+        }
+        if(job->callback) {
+            job->callback(status);
+        }
+        delete job;
+    }
+
+    converter.closeSession();
+}
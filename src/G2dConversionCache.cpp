@@ -0,0 +1,87 @@
+#include "G2dConversionCache.hpp"
+#include "G2dFrameHash.hpp"
+
+G2dConversionCache::G2dConversionCache(size_t maxBytes)
+    : mMaxBytes(maxBytes) {}
+
+G2dConversionCacheKey G2dConversionCache::makeKey(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    std::span<const uint8_t> srcBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    bool onCpu
+)
+{
+    G2dConversionCacheKey key;
+    key.srcHash = G2dFrameHash::hash64(srcBuffer);
+    key.srcSize = srcBuffer.size();
+    key.srcFormat = srcFormat;
+    key.destFormat = destFormat;
+    key.srcWidth = srcWidth;
+    key.srcHeight = srcHeight;
+    key.destWidth = destWidth;
+    key.destHeight = destHeight;
+    key.onCpu = onCpu;
+    return key;
+}
+
+std::span<const uint8_t> G2dConversionCache::lookup(const G2dConversionCacheKey& key) {
+    auto found = mIndex.find(key);
+    if(found == mIndex.end()) {
+        mStats.misses++;
+        return {};
+    }
+
+    mStats.hits++;
+    mEntries.splice(mEntries.begin(), mEntries, found->second);
+    return found->second->result;
+}
+
+void G2dConversionCache::insert(const G2dConversionCacheKey& key, std::span<const uint8_t> result) {
+    if(result.size() > mMaxBytes) {
+        return;
+    }
+
+    auto found = mIndex.find(key);
+    if(found != mIndex.end()) {
+        mStats.bytes -= found->second->result.size();
+        mEntries.erase(found->second);
+        mIndex.erase(found);
+    }
+
+    while(!mEntries.empty() && mStats.bytes + result.size() > mMaxBytes) {
+        Entry& oldest = mEntries.back();
+        mStats.bytes -= oldest.result.size();
+        mStats.evictions++;
+        mIndex.erase(oldest.key);
+        mEntries.pop_back();
+    }
+
+    mEntries.push_front({key, std::vector<uint8_t>(result.begin(), result.end())});
+    mIndex.emplace(key, mEntries.begin());
+    mStats.bytes += result.size();
+}
+
+void G2dConversionCache::clear() {
+    mEntries.clear();
+    mIndex.clear();
+    mStats.bytes = 0;
+}
+
+G2dConversionCacheStats G2dConversionCache::stats() const {
+    G2dConversionCacheStats stats = mStats;
+    stats.entries = mEntries.size();
+    return stats;
+}
+
+size_t G2dConversionCache::KeyHash::operator()(const G2dConversionCacheKey& key) const {
+    // the content hash is already well mixed, fold the parameters into it
+    uint64_t hash = key.srcHash;
+    hash ^= (static_cast<uint64_t>(key.srcFormat) << 8U) ^ static_cast<uint64_t>(key.destFormat);
+    hash ^= (key.srcWidth << 48U) ^ (key.srcHeight << 24U) ^ (key.destWidth << 32U) ^ key.destHeight;
+    hash ^= key.onCpu ? 1ULL << 63U : 0;
+    return static_cast<size_t>(hash);
+}
@@ -0,0 +1,139 @@
+#include "G2dConversionClient.hpp"
+#include "G2dConversionProtocol.hpp"
+#include "G2dFormatManager.hpp"
+#include "G2dUnixSocket.hpp"
+
+#include <unistd.h>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+G2dConversionClient::G2dConversionClient(std::string socketPath)
+    : mSocketPath(std::move(socketPath)) {}
+
+G2dConversionClient::~G2dConversionClient() {
+    disconnect();
+}
+
+G2dPixelFormatConverterStatus G2dConversionClient::connect() {
+    if(mSocketFd >= 0) {
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    }
+    if(G2dUnixSocket::connectTo(mSocketPath, mSocketFd) != G2dUnixSocketStatus::SUCCESS) {
+        return G2dPixelFormatConverterStatus::CONNECTION_ERROR;
+    }
+    return G2dPixelFormatConverterStatus::SUCCESS;
+}
+
+void G2dConversionClient::disconnect() {
+    if(mSocketFd >= 0) {
+        close(mSocketFd);
+        mSocketFd = -1;
+    }
+}
+
+G2dPixelFormatConverterStatus G2dConversionClient::convertImage(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const std::vector<uint8_t>& srcBuffer,
+    std::vector<uint8_t>& destBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight
+)
+{
+    std::optional<size_t> destSize = G2dFormatManager::getFrameSize(destFormat, destWidth, destHeight);
+    if(!destSize.has_value() || srcBuffer.empty() || *destSize == 0) {
+        std::cerr << "Invalid source or destination format" << "\n";
+        return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+    }
+
+    // frames are only reallocated when they are too small for the current request
+    if(
+        (mSrcFrame.size() < srcBuffer.size() && mSrcFrame.allocate(srcBuffer.size()) != G2dSharedFrameStatus::SUCCESS) ||
+        (mDestFrame.size() < *destSize && mDestFrame.allocate(*destSize) != G2dSharedFrameStatus::SUCCESS)
+    ) {
+        return G2dPixelFormatConverterStatus::MEMORY_ALLOCATION_ERROR;
+    }
+
+    std::memcpy(mSrcFrame.data(), srcBuffer.data(), srcBuffer.size());
+
+    const G2dPixelFormatConverterStatus status = convertImage(
+        srcFormat,
+        destFormat,
+        mSrcFrame,
+        mDestFrame,
+        srcWidth,
+        srcHeight,
+        destWidth,
+        destHeight
+    );
+    if(status != G2dPixelFormatConverterStatus::SUCCESS) {
+        return status;
+    }
+
+    destBuffer.resize(*destSize);
+    std::memcpy(destBuffer.data(), mDestFrame.data(), *destSize);
+
+    return G2dPixelFormatConverterStatus::SUCCESS;
+}
+
+G2dPixelFormatConverterStatus G2dConversionClient::convertImage(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const G2dSharedFrame& srcFrame,
+    G2dSharedFrame& destFrame,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight
+)
+{
+    if(srcFrame.fd() < 0 || destFrame.fd() < 0) {
+        std::cerr << "Source or destination frame is not allocated" << "\n";
+        return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+    }
+    if(connect() != G2dPixelFormatConverterStatus::SUCCESS) {
+        return G2dPixelFormatConverterStatus::CONNECTION_ERROR;
+    }
+
+    G2dConversionRequest request {};
+    request.magic = G2dConversionProtocolMagic;
+    request.version = G2dConversionProtocolVersion;
+    request.srcFormat = static_cast<int32_t>(srcFormat);
+    request.destFormat = static_cast<int32_t>(destFormat);
+    request.srcWidth = srcWidth;
+    request.srcHeight = srcHeight;
+    request.destWidth = destWidth;
+    request.destHeight = destHeight;
+    request.srcSize = srcFrame.size();
+    request.destSize = destFrame.size();
+
+    const std::array<int, 2> fds = {srcFrame.fd(), destFrame.fd()};
+    G2dConversionResponse response {};
+    std::vector<int> receivedFds;
+
+    if(
+        G2dUnixSocket::sendMessage(
+            mSocketFd,
+            std::as_bytes(std::span(&request, 1)),
+            fds
+        ) != G2dUnixSocketStatus::SUCCESS ||
+        G2dUnixSocket::receiveMessage(
+            mSocketFd,
+            std::as_writable_bytes(std::span(&response, 1)),
+            receivedFds
+        ) != G2dUnixSocketStatus::SUCCESS
+    ) {
+        std::cerr << "Lost connection to the conversion server" << "\n";
+        for(int fd : receivedFds) {
+            close(fd);
+        }
+        disconnect();
+        return G2dPixelFormatConverterStatus::CONNECTION_ERROR;
+    }
+
+    return static_cast<G2dPixelFormatConverterStatus>(response.status);
+}
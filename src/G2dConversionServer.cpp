@@ -0,0 +1,225 @@
+#include "G2dConversionServer.hpp"
+#include "G2dConversionProtocol.hpp"
+#include "G2dFormatManager.hpp"
+#include "G2dSharedFrame.hpp"
+#include "G2dUnixSocket.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace {
+    /// @brief Checks the formats and image sizes of a request before any of them is used
+    /// @return G2dPixelFormatConverterStatus::SUCCESS if the request can be converted, the status to reply with otherwise
+    G2dPixelFormatConverterStatus checkRequest(const G2dConversionRequest& request) {
+        if(
+            !G2dFormatManager::getFormatMetadata(static_cast<OrqaG2dFormat>(request.srcFormat)).has_value() ||
+            !G2dFormatManager::getFormatMetadata(static_cast<OrqaG2dFormat>(request.destFormat)).has_value()
+        ) {
+            return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+        }
+
+        for(const uint64_t dimension : {request.srcWidth, request.srcHeight, request.destWidth, request.destHeight}) {
+            if(dimension == 0 || dimension > G2dConversionMaxDimension) {
+                return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+            }
+        }
+
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    }
+}
+
+G2dConversionServer::G2dConversionServer(std::string socketPath)
+    : mSocketPath(std::move(socketPath)) {}
+
+G2dConversionServer::~G2dConversionServer() {
+    if(mListenFd >= 0) {
+        close(mListenFd);
+        unlink(mSocketPath.c_str());
+    }
+    if(mWakeFd >= 0) {
+        close(mWakeFd);
+    }
+}
+
+G2dConversionServerStatus G2dConversionServer::start() {
+    if(mConverter.openSession() != G2dPixelFormatConverterStatus::SUCCESS) {
+        return G2dConversionServerStatus::DEVICE_ERROR;
+    }
+
+    mWakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(mWakeFd < 0) {
+        std::cerr << "Failed to create the wake up event" << "\n";
+        return G2dConversionServerStatus::SOCKET_ERROR;
+    }
+
+    if(G2dUnixSocket::listenOn(mSocketPath, mListenFd) != G2dUnixSocketStatus::SUCCESS) {
+        return G2dConversionServerStatus::SOCKET_ERROR;
+    }
+
+    mRunning = true;
+    return G2dConversionServerStatus::SUCCESS;
+}
+
+G2dConversionServerStatus G2dConversionServer::run() {
+    if(mListenFd < 0 || mWakeFd < 0) {
+        std::cerr << "Conversion server is not started" << "\n";
+        return G2dConversionServerStatus::SOCKET_ERROR;
+    }
+
+    // slot 0 is the wake up event, slot 1 the listening socket, the rest are clients[i - 2]
+    std::vector<pollfd> pollFds = {
+        {mWakeFd, POLLIN, 0},
+        {mListenFd, POLLIN, 0}
+    };
+    std::vector<Client> clients;
+
+    G2dConversionServerStatus status = G2dConversionServerStatus::SUCCESS;
+    while(mRunning) {
+        if(poll(pollFds.data(), pollFds.size(), -1) < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Failed to wait for clients" << "\n";
+            status = G2dConversionServerStatus::SOCKET_ERROR;
+            break;
+        }
+
+        if((pollFds[1].revents & POLLIN) != 0) {
+            const int clientFd = accept4(mListenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if(clientFd >= 0) {
+                pollFds.push_back({clientFd, POLLIN, 0});
+                clients.emplace_back().fd = clientFd;
+            }
+        }
+
+        for(size_t i = 2; i < pollFds.size();) {
+            const short events = pollFds[i].revents;
+            pollFds[i].revents = 0;
+            if(events != 0 && ((events & POLLIN) == 0 || !handleRequest(clients[i - 2]))) {
+                closeClient(clients[i - 2]);
+                clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i - 2));
+                pollFds.erase(pollFds.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            i++;
+        }
+    }
+
+    for(Client& client : clients) {
+        closeClient(client);
+    }
+    mConverter.closeSession();
+
+    return status;
+}
+
+void G2dConversionServer::stop() {
+    mRunning = false;
+    if(mWakeFd >= 0) {
+        const uint64_t value = 1;
+        [[maybe_unused]] const ssize_t written = write(mWakeFd, &value, sizeof(value));
+    }
+}
+
+bool G2dConversionServer::handleRequest(Client& client) {
+    const G2dUnixSocketStatus receiveStatus = G2dUnixSocket::receiveAvailable(
+        client.fd,
+        std::as_writable_bytes(std::span(&client.request, 1)),
+        client.received,
+        client.fds
+    );
+    if(receiveStatus == G2dUnixSocketStatus::WOULD_BLOCK) {
+        return true;
+    }
+    if(receiveStatus != G2dUnixSocketStatus::SUCCESS) {
+        return false;
+    }
+
+    // the request is complete, the client starts over with the next one
+    const G2dConversionRequest request = client.request;
+    std::vector<int> fds = std::move(client.fds);
+    client.request = {};
+    client.received = 0;
+    client.fds.clear();
+
+    G2dConversionResponse response {};
+    response.status = static_cast<int32_t>(G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR);
+
+    G2dSharedFrame srcFrame;
+    G2dSharedFrame destFrame;
+    const auto srcFormat = static_cast<OrqaG2dFormat>(request.srcFormat);
+    const auto destFormat = static_cast<OrqaG2dFormat>(request.destFormat);
+
+    if(
+        request.magic != G2dConversionProtocolMagic ||
+        request.version != G2dConversionProtocolVersion ||
+        fds.size() != 2
+    ) {
+        std::cerr << "Received a malformed conversion request" << "\n";
+        for(int fd : fds) {
+            close(fd);
+        }
+        return false;
+    }
+
+    const G2dPixelFormatConverterStatus requestStatus = checkRequest(request);
+    if(requestStatus != G2dPixelFormatConverterStatus::SUCCESS) {
+        std::cerr << "Received a conversion request with an unknown format or image size" << "\n";
+        for(int fd : fds) {
+            close(fd);
+        }
+        response.status = static_cast<int32_t>(requestStatus);
+    }
+    else if(
+        srcFrame.attach(fds[0], request.srcSize, false) != G2dSharedFrameStatus::SUCCESS ||
+        destFrame.attach(fds[1], request.destSize, true) != G2dSharedFrameStatus::SUCCESS
+    ) {
+        // attach() takes ownership of the descriptor even when it fails
+        if(srcFrame.fd() < 0) {
+            close(fds[1]);
+        }
+        response.status = static_cast<int32_t>(G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR);
+    }
+    else {
+        const G2dPixelFormatConverterStatus status = mConverter.convertImage(
+            srcFormat,
+            destFormat,
+            std::as_const(srcFrame).span(),
+            destFrame.span(),
+            request.srcWidth,
+            request.srcHeight,
+            request.destWidth,
+            request.destHeight
+        );
+        response.status = static_cast<int32_t>(status);
+        if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+            response.destSize = G2dFormatManager::getFrameSize(
+                destFormat,
+                request.destWidth,
+                request.destHeight
+            ).value_or(0);
+        }
+    }
+
+    // the reply is small and the client waits for it, so a full socket buffer means a client that does not read
+    return G2dUnixSocket::sendMessage(
+        client.fd,
+        std::as_bytes(std::span(&response, 1)),
+        {}
+    ) == G2dUnixSocketStatus::SUCCESS;
+}
+
+void G2dConversionServer::closeClient(Client& client) {
+    for(int fd : client.fds) {
+        close(fd);
+    }
+    client.fds.clear();
+    close(client.fd);
+    client.fd = -1;
+}
@@ -0,0 +1,895 @@
+#include "G2dCpuConverter.hpp"
+#include "G2dCpuKernels.hpp"
+#include "G2dFormatManager.hpp"
+#include "G2dFrameAllocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// @brief Rows per band of multi-output conversions, small enough for a band of a 1080p RGBA source to stay in L2
+constexpr size_t MultiOutputBandRows = 16;
+
+/// @brief Scratch bytes per image column used by convertYuvToYuv(), the most of any band conversion
+constexpr size_t YuvToYuvScratchPerColumn = 8;
+
+/// @brief Scratch bytes per image column used by convertRgbToYuv()
+constexpr size_t RgbToYuvScratchPerColumn = 4;
+
+enum class YuvStorage {
+    PLANAR,
+    SEMI_PLANAR,
+    PACKED
+};
+
+/// @brief Describes how a YUV format stores its samples
+struct YuvFormatInfo {
+    YuvStorage storage;
+
+    /// @brief Number of image rows sharing one chroma row, 2 for 4:2:0 and 1 for 4:2:2
+    size_t chromaVerticalSubsampling;
+
+    /// @brief V is stored before U (YV12, NV21, NV61)
+    bool vFirst;
+
+    /// @brief Macropixel layout of packed formats
+    G2dPackedYuvOrder order;
+};
+
+std::optional<YuvFormatInfo> getYuvFormatInfo(OrqaG2dFormat format) {
+    switch(format) {
+        case OrqaG2dFormat::FMT_I420:
+            return YuvFormatInfo {YuvStorage::PLANAR, 2, false, {}};
+        case OrqaG2dFormat::FMT_YV12:
+            return YuvFormatInfo {YuvStorage::PLANAR, 2, true, {}};
+        case OrqaG2dFormat::FMT_NV12:
+            return YuvFormatInfo {YuvStorage::SEMI_PLANAR, 2, false, {}};
+        case OrqaG2dFormat::FMT_NV21:
+            return YuvFormatInfo {YuvStorage::SEMI_PLANAR, 2, true, {}};
+        case OrqaG2dFormat::FMT_NV16:
+            return YuvFormatInfo {YuvStorage::SEMI_PLANAR, 1, false, {}};
+        case OrqaG2dFormat::FMT_NV61:
+            return YuvFormatInfo {YuvStorage::SEMI_PLANAR, 1, true, {}};
+        case OrqaG2dFormat::FMT_YUYV:
+            return YuvFormatInfo {YuvStorage::PACKED, 1, false, {0, 1, 2, 3}};
+        case OrqaG2dFormat::FMT_YVYU:
+            return YuvFormatInfo {YuvStorage::PACKED, 1, false, {0, 3, 2, 1}};
+        case OrqaG2dFormat::FMT_UYVY:
+            return YuvFormatInfo {YuvStorage::PACKED, 1, false, {1, 0, 3, 2}};
+        case OrqaG2dFormat::FMT_VYUY:
+            return YuvFormatInfo {YuvStorage::PACKED, 1, false, {1, 2, 3, 0}};
+        default:
+            return {};
+    }
+}
+
+std::optional<G2dRgbLayout> getRgbLayout(OrqaG2dFormat format) {
+    switch(format) {
+        case OrqaG2dFormat::FMT_RGBA8888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 4, 0, 1, 2, true, 3};
+        case OrqaG2dFormat::FMT_RGBX8888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 4, 0, 1, 2, false, 3};
+        case OrqaG2dFormat::FMT_ARGB8888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 4, 1, 2, 3, true, 0};
+        case OrqaG2dFormat::FMT_XRGB8888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 4, 1, 2, 3, false, 0};
+        case OrqaG2dFormat::FMT_BGRX8888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 4, 2, 1, 0, false, 3};
+        case OrqaG2dFormat::FMT_BGRA8888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 4, 2, 1, 0, true, 3};
+        case OrqaG2dFormat::FMT_RGB888:
+            return G2dRgbLayout {G2dRgbPacking::BYTES, 3, 0, 1, 2, false, 0};
+        case OrqaG2dFormat::FMT_RGB565:
+            return G2dRgbLayout {G2dRgbPacking::RGB565, 2, 0, 0, 0, false, 0};
+        case OrqaG2dFormat::FMT_RGBA5551:
+            return G2dRgbLayout {G2dRgbPacking::RGBA5551, 2, 0, 0, 0, true, 0};
+        case OrqaG2dFormat::FMT_RGBX5551:
+            return G2dRgbLayout {G2dRgbPacking::RGBA5551, 2, 0, 0, 0, false, 0};
+        default:
+            return {};
+    }
+}
+
+/// @brief A YUV frame split into row accessors
+struct YuvFrame {
+    YuvFormatInfo info;
+    G2dFrameLayout layout;
+    uint8_t* data;
+
+    uint8_t* lumaRow(size_t row) const {
+        return data + layout.planes[0].offset + (row * layout.planes[0].stride);
+    }
+
+    /// @brief Row of a chroma plane, 0 for U and 1 for V, of planar formats
+    uint8_t* planarChromaRow(size_t chroma, size_t row) const {
+        const G2dPlaneLayout& plane = layout.planes[(chroma == 1) != info.vFirst ? 2 : 1];
+        return data + plane.offset + ((row / info.chromaVerticalSubsampling) * plane.stride);
+    }
+
+    /// @brief Row of the interleaved chroma plane of semi-planar formats
+    uint8_t* semiPlanarChromaRow(size_t row) const {
+        const G2dPlaneLayout& plane = layout.planes[1];
+        return data + plane.offset + ((row / info.chromaVerticalSubsampling) * plane.stride);
+    }
+};
+
+/// @brief Helper threads for banded conversions, shared by the whole process and kept between frames
+/// A conversion offers its task to up to helperCount threads of the pool and works on it itself.
+/// Once the calling thread runs out of bands it withdraws the offer, so it only waits for the
+/// helpers already working on its frame, never for helpers busy with another conversion.
+class BandThreadPool {
+    public:
+        static BandThreadPool& instance() {
+            static BandThreadPool pool;
+            return pool;
+        }
+
+        ~BandThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+            }
+            mWake.notify_all();
+            for(std::thread& thread : mThreads) {
+                thread.join();
+            }
+        }
+
+        /// @brief Runs a task on the calling thread and up to helperCount pool threads
+        /// The task must return once there is no work left, no matter how many threads run it.
+        void run(size_t helperCount, const std::function<void()>& task) {
+            Task offer {&task, 0, 0};
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                try {
+                    while(mThreads.size() < helperCount) {
+                        mThreads.emplace_back(&BandThreadPool::runThread, this);
+                    }
+                }
+                catch(const std::system_error&) {
+                    // the conversion makes do with the threads that exist
+                    std::cerr << "Failed to start a conversion helper thread" << "\n";
+                }
+                offer.unclaimed = std::min(helperCount, mThreads.size());
+                if(offer.unclaimed != 0) {
+                    mTasks.push_back(&offer);
+                }
+            }
+            mWake.notify_all();
+
+            task();
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            if(offer.unclaimed != 0) {
+                mTasks.erase(std::find(mTasks.begin(), mTasks.end(), &offer));
+                offer.unclaimed = 0;
+            }
+            mDone.wait(lock, [&offer]() { return offer.running == 0; });
+        }
+
+    private:
+        /// @brief A task offered to the pool, lives on the stack of the thread that runs it
+        struct Task {
+            const std::function<void()>* work;
+            /// @brief Pool threads that may still join the task
+            size_t unclaimed;
+            /// @brief Pool threads working on the task right now
+            size_t running;
+        };
+
+        void runThread() {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while(true) {
+                mWake.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+                if(mTasks.empty()) {
+                    return;
+                }
+
+                Task* task = mTasks.front();
+                if(--task->unclaimed == 0) {
+                    mTasks.pop_front();
+                }
+                task->running++;
+
+                lock.unlock();
+                (*task->work)();
+                lock.lock();
+
+                if(--task->running == 0) {
+                    mDone.notify_all();
+                }
+            }
+        }
+
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        std::condition_variable mDone;
+        std::deque<Task*> mTasks;
+        std::vector<std::thread> mThreads;
+        bool mStopping = false;
+};
+
+/// @brief Scratch memory of the calling thread, kept between conversions
+/// @param size Number of bytes needed
+uint8_t* threadScratch(size_t size) {
+    thread_local G2dFrameBuffer scratch;
+    if(scratch.size() < size) {
+        scratch.resize(size);
+    }
+    return scratch.data();
+}
+
+/// @brief Runs a conversion of image rows [firstRow, lastRow) over bands of the frame
+/// The calling thread and up to options.threadCount - 1 threads of the band thread pool take
+/// bands of options.bandRows rows until the frame is done. Every thread passes its own scratch
+/// memory of scratchSize bytes to all of its bands.
+template<typename ConvertRows>
+void convertInBands(size_t height, const G2dCpuConversionOptions& options, size_t scratchSize, const ConvertRows& convertRows) {
+    const size_t threadCount = std::clamp<size_t>(options.threadCount, 1, std::max<size_t>(1, height / 2));
+    size_t bandRows = options.bandRows == 0 ? (height + threadCount - 1) / threadCount : options.bandRows;
+
+    // bands start on even rows, so rows sharing chroma stay together
+    bandRows = std::max<size_t>(2, (bandRows + 1) & ~static_cast<size_t>(1));
+    if(threadCount == 1) {
+        uint8_t* scratch = threadScratch(scratchSize);
+        for(size_t row = 0; row < height; row += bandRows) {
+            convertRows(row, std::min(row + bandRows, height), scratch);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextRow {0};
+    BandThreadPool::instance().run(threadCount - 1, [&]() {
+        uint8_t* scratch = threadScratch(scratchSize);
+        for(size_t row = nextRow.fetch_add(bandRows); row < height; row = nextRow.fetch_add(bandRows)) {
+            convertRows(row, std::min(row + bandRows, height), scratch);
+        }
+    });
+}
+
+/// @brief Repacks a YUV frame into another YUV format, two image rows at a time
+/// Luma is copied as is. Chroma is taken from the source rows, averaged when going
+/// from 4:2:2 to 4:2:0 and repeated when going from 4:2:0 to 4:2:2. Samples are written
+/// straight into the destination planes whenever the layouts allow it.
+/// scratch must hold YuvToYuvScratchPerColumn * width bytes.
+void convertYuvToYuv(const YuvFrame& src, const YuvFrame& dest, size_t width, size_t firstRow, size_t lastRow, uint8_t* scratch) {
+    const size_t chromaWidth = width / 2;
+    uint8_t* scratchLuma[2] = {scratch, scratch + width};
+    uint8_t* scratchU[2] = {scratch + (2 * width), scratch + (3 * width)};
+    uint8_t* scratchV[2] = {scratch + (4 * width), scratch + (5 * width)};
+    uint8_t* averagedU = scratch + (6 * width);
+    uint8_t* averagedV = scratch + (7 * width);
+
+    const bool destHasLumaPlane = dest.info.storage != YuvStorage::PACKED;
+    const bool deinterleaveIntoDest =
+        dest.info.storage == YuvStorage::PLANAR &&
+        dest.info.chromaVerticalSubsampling == src.info.chromaVerticalSubsampling;
+
+    for(size_t y = firstRow; y < lastRow; y += 2) {
+        const uint8_t* lumaRows[2];
+        const uint8_t* uRows[2];
+        const uint8_t* vRows[2];
+
+        for(size_t r = 0; r < 2; r++) {
+            const size_t row = y + r;
+            if(src.info.storage == YuvStorage::PACKED) {
+                uint8_t* luma = destHasLumaPlane ? dest.lumaRow(row) : scratchLuma[r];
+                G2dCpuKernels::unpackPacked422Row(src.lumaRow(row), src.info.order, luma, scratchU[r], scratchV[r], width);
+                lumaRows[r] = luma;
+                uRows[r] = scratchU[r];
+                vRows[r] = scratchV[r];
+                continue;
+            }
+
+            lumaRows[r] = src.lumaRow(row);
+            if(r == 1 && src.info.chromaVerticalSubsampling == 2) {
+                uRows[1] = uRows[0];
+                vRows[1] = vRows[0];
+            }
+            else if(src.info.storage == YuvStorage::PLANAR) {
+                uRows[r] = src.planarChromaRow(0, row);
+                vRows[r] = src.planarChromaRow(1, row);
+            }
+            else {
+                uint8_t* u = deinterleaveIntoDest ? dest.planarChromaRow(0, row) : scratchU[r];
+                uint8_t* v = deinterleaveIntoDest ? dest.planarChromaRow(1, row) : scratchV[r];
+                const uint8_t* interleaved = src.semiPlanarChromaRow(row);
+                if(src.info.vFirst) {
+                    G2dCpuKernels::deinterleaveRow(interleaved, v, u, chromaWidth);
+                }
+                else {
+                    G2dCpuKernels::deinterleaveRow(interleaved, u, v, chromaWidth);
+                }
+                uRows[r] = u;
+                vRows[r] = v;
+            }
+        }
+
+        // 4:2:2 -> 4:2:0, one chroma row for both image rows
+        if(dest.info.chromaVerticalSubsampling == 2 && src.info.chromaVerticalSubsampling == 1) {
+            G2dCpuKernels::averageRows(uRows[0], uRows[1], averagedU, chromaWidth);
+            G2dCpuKernels::averageRows(vRows[0], vRows[1], averagedV, chromaWidth);
+            uRows[0] = averagedU;
+            vRows[0] = averagedV;
+        }
+
+        for(size_t r = 0; r < 2; r++) {
+            const size_t row = y + r;
+            if(dest.info.storage == YuvStorage::PACKED) {
+                G2dCpuKernels::packPacked422Row(lumaRows[r], uRows[r], vRows[r], dest.info.order, dest.lumaRow(row), width);
+                continue;
+            }
+
+            if(lumaRows[r] != dest.lumaRow(row)) {
+                std::memcpy(dest.lumaRow(row), lumaRows[r], width);
+            }
+            if(r == 1 && dest.info.chromaVerticalSubsampling == 2) {
+                continue;
+            }
+
+            if(dest.info.storage == YuvStorage::PLANAR) {
+                uint8_t* u = dest.planarChromaRow(0, row);
+                uint8_t* v = dest.planarChromaRow(1, row);
+                if(uRows[r] != u) {
+                    std::memcpy(u, uRows[r], chromaWidth);
+                }
+                if(vRows[r] != v) {
+                    std::memcpy(v, vRows[r], chromaWidth);
+                }
+            }
+            else if(dest.info.vFirst) {
+                G2dCpuKernels::interleaveRow(vRows[r], uRows[r], dest.semiPlanarChromaRow(row), chromaWidth);
+            }
+            else {
+                G2dCpuKernels::interleaveRow(uRows[r], vRows[r], dest.semiPlanarChromaRow(row), chromaWidth);
+            }
+        }
+    }
+}
+
+/// @brief Encodes an RGB frame into a YUV format, two image rows at a time
+/// Luma and chroma are computed in one pass over the source rows and written straight into
+/// the destination planes when it has them, so no full resolution chroma is ever stored.
+/// scratch must hold RgbToYuvScratchPerColumn * width bytes.
+void convertRgbToYuv(
+    const uint8_t* src,
+    const G2dRgbLayout& layout,
+    const YuvFrame& dest,
+    size_t width,
+    size_t firstRow,
+    size_t lastRow,
+    uint8_t* scratch
+)
+{
+    const size_t chromaWidth = width / 2;
+    const size_t srcStride = width * layout.bytesPerPixel;
+    uint8_t* scratchLuma[2] = {scratch, scratch + width};
+    uint8_t* scratchU = scratch + (2 * width);
+    uint8_t* scratchV = scratch + (3 * width);
+
+    const bool destHasLumaPlane = dest.info.storage != YuvStorage::PACKED;
+    for(size_t y = firstRow; y < lastRow; y += 2) {
+        uint8_t* lumaRows[2];
+        for(size_t r = 0; r < 2; r++) {
+            lumaRows[r] = destHasLumaPlane ? dest.lumaRow(y + r) : scratchLuma[r];
+        }
+
+        if(dest.info.chromaVerticalSubsampling == 2) {
+            uint8_t* u = dest.info.storage == YuvStorage::PLANAR ? dest.planarChromaRow(0, y) : scratchU;
+            uint8_t* v = dest.info.storage == YuvStorage::PLANAR ? dest.planarChromaRow(1, y) : scratchV;
+            G2dCpuKernels::rgbRowsToYuv420(
+                src + (y * srcStride),
+                src + ((y + 1) * srcStride),
+                layout,
+                lumaRows[0],
+                lumaRows[1],
+                u,
+                v,
+                width
+            );
+            if(dest.info.storage == YuvStorage::SEMI_PLANAR) {
+                G2dCpuKernels::interleaveRow(dest.info.vFirst ? v : u, dest.info.vFirst ? u : v, dest.semiPlanarChromaRow(y), chromaWidth);
+            }
+            continue;
+        }
+
+        for(size_t r = 0; r < 2; r++) {
+            const size_t row = y + r;
+            G2dCpuKernels::rgbRowToYuv422(src + (row * srcStride), layout, lumaRows[r], scratchU, scratchV, width);
+            if(dest.info.storage == YuvStorage::PACKED) {
+                G2dCpuKernels::packPacked422Row(lumaRows[r], scratchU, scratchV, dest.info.order, dest.lumaRow(row), width);
+            }
+            else {
+                G2dCpuKernels::interleaveRow(
+                    dest.info.vFirst ? scratchV : scratchU,
+                    dest.info.vFirst ? scratchU : scratchV,
+                    dest.semiPlanarChromaRow(row),
+                    chromaWidth
+                );
+            }
+        }
+    }
+}
+
+/// @brief Extracts the luma of image rows [firstRow, lastRow) into an 8 bit gray frame
+/// Luma planes are copied as they are, packed 4:2:2 rows have their luma split out and RGB rows
+/// are encoded. The source is either an RGB frame described by srcRgbLayout or a YUV frame.
+void convertToGray(
+    const uint8_t* src,
+    const std::optional<G2dRgbLayout>& srcRgbLayout,
+    const std::optional<YuvFrame>& srcYuv,
+    uint8_t* dest,
+    size_t width,
+    size_t firstRow,
+    size_t lastRow
+)
+{
+    for(size_t row = firstRow; row < lastRow; row++) {
+        uint8_t* gray = dest + (row * width);
+        if(srcRgbLayout.has_value()) {
+            G2dCpuKernels::rgbRowToLuma(src + (row * width * srcRgbLayout->bytesPerPixel), *srcRgbLayout, gray, width);
+        }
+        else if(srcYuv->info.storage == YuvStorage::PACKED) {
+            G2dCpuKernels::extractPacked422LumaRow(srcYuv->lumaRow(row), srcYuv->info.order, gray, width);
+        }
+        else {
+            std::memcpy(gray, srcYuv->lumaRow(row), width);
+        }
+    }
+}
+
+
+/// @brief Part of an overlay layer that lies inside the frame, in frame coordinates
+struct OverlayRect {
+    size_t left;
+    size_t top;
+    size_t right;
+    size_t bottom;
+};
+
+std::optional<OverlayRect> clipOverlay(const G2dOverlayLayer& layer, size_t width, size_t height) {
+    if(layer.left >= width || layer.top >= height || layer.width == 0 || layer.height == 0 || layer.globalAlpha == 0) {
+        return {};
+    }
+    return OverlayRect {layer.left, layer.top, std::min(width, layer.left + layer.width), std::min(height, layer.top + layer.height)};
+}
+
+bool overlaysFit(std::span<const G2dOverlayLayer> overlays) {
+    return std::all_of(overlays.begin(), overlays.end(), [](const G2dOverlayLayer& layer) {
+        return layer.pixels.size() >= layer.width * layer.height * 4;
+    });
+}
+
+/// @brief Address of the overlay pixel at the given frame position
+const uint8_t* overlayPixel(const G2dOverlayLayer& layer, size_t x, size_t y) {
+    return layer.pixels.data() + ((((y - layer.top) * layer.width) + (x - layer.left)) * 4);
+}
+
+/// @brief Blends overlay layers into image rows [firstRow, lastRow) of an RGB frame
+void blendOverlaysIntoRgb(
+    uint8_t* data,
+    const G2dRgbLayout& layout,
+    size_t width,
+    size_t height,
+    std::span<const G2dOverlayLayer> overlays,
+    size_t firstRow,
+    size_t lastRow
+)
+{
+    for(const G2dOverlayLayer& layer : overlays) {
+        std::optional<OverlayRect> rect = clipOverlay(layer, width, height);
+        if(!rect.has_value()) {
+            continue;
+        }
+        for(size_t row = std::max(firstRow, rect->top); row < std::min(lastRow, rect->bottom); row++) {
+            G2dCpuKernels::blendRgbaRow(
+                overlayPixel(layer, rect->left, row),
+                layer.globalAlpha,
+                data + (((row * width) + rect->left) * layout.bytesPerPixel),
+                layout,
+                rect->right - rect->left
+            );
+        }
+    }
+}
+
+/// @brief Blends the luma of overlay layers into image rows [firstRow, lastRow) of an 8 bit gray frame
+void blendOverlaysIntoGray(
+    uint8_t* data,
+    size_t width,
+    size_t height,
+    std::span<const G2dOverlayLayer> overlays,
+    size_t firstRow,
+    size_t lastRow
+)
+{
+    for(const G2dOverlayLayer& layer : overlays) {
+        std::optional<OverlayRect> rect = clipOverlay(layer, width, height);
+        if(!rect.has_value()) {
+            continue;
+        }
+        for(size_t row = std::max(firstRow, rect->top); row < std::min(lastRow, rect->bottom); row++) {
+            G2dCpuKernels::blendRgbaRowIntoLuma(
+                overlayPixel(layer, rect->left, row),
+                layer.globalAlpha,
+                data + (row * width) + rect->left,
+                1,
+                rect->right - rect->left
+            );
+        }
+    }
+}
+
+/// @brief Blends overlay layers into image rows [firstRow, lastRow) of a YUV frame
+/// Luma is blended per pixel. Each chroma sample is blended with the coverage of the pixels sharing it,
+/// so firstRow must be a multiple of the vertical chroma subsampling.
+void blendOverlaysIntoYuv(
+    const YuvFrame& frame,
+    size_t width,
+    size_t height,
+    std::span<const G2dOverlayLayer> overlays,
+    size_t firstRow,
+    size_t lastRow
+)
+{
+    const bool packed = frame.info.storage == YuvStorage::PACKED;
+    const size_t chromaRows = frame.info.chromaVerticalSubsampling;
+
+    for(const G2dOverlayLayer& layer : overlays) {
+        std::optional<OverlayRect> rect = clipOverlay(layer, width, height);
+        if(!rect.has_value()) {
+            continue;
+        }
+        const size_t rowEnd = std::min(lastRow, rect->bottom);
+
+        for(size_t row = std::max(firstRow, rect->top); row < rowEnd; row++) {
+            uint8_t* luma = packed
+                ? frame.lumaRow(row) + (2 * rect->left) + frame.info.order.y0
+                : frame.lumaRow(row) + rect->left;
+            G2dCpuKernels::blendRgbaRowIntoLuma(overlayPixel(layer, rect->left, row), layer.globalAlpha, luma, packed ? 2 : 1, rect->right - rect->left);
+        }
+
+        const size_t firstChromaRow = std::max(firstRow, rect->top / chromaRows * chromaRows);
+        for(size_t row = firstChromaRow; row < rowEnd; row += chromaRows) {
+            for(size_t chromaX = rect->left / 2; chromaX < (rect->right + 1) / 2; chromaX++) {
+                const uint8_t* pixels[4] = {};
+                size_t count = 0;
+                for(size_t y = row; y < row + chromaRows; y++) {
+                    for(size_t x = 2 * chromaX; x < (2 * chromaX) + 2; x++) {
+                        const bool covered = x >= rect->left && x < rect->right && y >= rect->top && y < rect->bottom;
+                        pixels[count++] = covered ? overlayPixel(layer, x, y) : nullptr;
+                    }
+                }
+
+                uint8_t* u = nullptr;
+                uint8_t* v = nullptr;
+                if(frame.info.storage == YuvStorage::PLANAR) {
+                    u = frame.planarChromaRow(0, row) + chromaX;
+                    v = frame.planarChromaRow(1, row) + chromaX;
+                }
+                else if(frame.info.storage == YuvStorage::SEMI_PLANAR) {
+                    uint8_t* pair = frame.semiPlanarChromaRow(row) + (2 * chromaX);
+                    u = pair + (frame.info.vFirst ? 1 : 0);
+                    v = pair + (frame.info.vFirst ? 0 : 1);
+                }
+                else {
+                    uint8_t* macropixel = frame.lumaRow(row) + (4 * chromaX);
+                    u = macropixel + frame.info.order.u;
+                    v = macropixel + frame.info.order.v;
+                }
+                G2dCpuKernels::blendRgbaIntoChroma(pixels, count, layer.globalAlpha, u, v);
+            }
+        }
+    }
+}
+
+}
+
+bool G2dCpuConverter::isConversionSupported(OrqaG2dFormat srcFormat, OrqaG2dFormat destFormat, size_t width, size_t height) {
+    if(srcFormat == destFormat || width == 0 || height == 0) {
+        return false;
+    }
+
+    // chroma is shared by pixel pairs, so the kernels work on whole pairs of rows and columns
+    const bool srcIsYuv = getYuvFormatInfo(srcFormat).has_value();
+    const bool srcIsRgb = getRgbLayout(srcFormat).has_value();
+    if(srcIsRgb && getRgbLayout(destFormat).has_value()) {
+        return true;
+    }
+    if(destFormat == OrqaG2dFormat::FMT_GRAY8) {
+        return srcIsRgb || (srcIsYuv && width % 2 == 0 && height % 2 == 0);
+    }
+    if((srcIsYuv || srcIsRgb) && getYuvFormatInfo(destFormat).has_value()) {
+        return width % 2 == 0 && height % 2 == 0;
+    }
+    return false;
+}
+
+G2dCpuConverterStatus G2dCpuConverter::convertImage(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    std::span<const uint8_t> srcBuffer,
+    std::span<uint8_t> destBuffer,
+    size_t width,
+    size_t height,
+    const G2dCpuConversionOptions& options
+)
+{
+    if(!isConversionSupported(srcFormat, destFormat, width, height)) {
+        std::cerr << "Unsupported CPU format conversion" << "\n";
+        return G2dCpuConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+    }
+
+    const std::optional<G2dFrameLayout> srcLayout = G2dFormatManager::getFrameLayout(srcFormat, width, height);
+    const std::optional<G2dFrameLayout> destLayout = G2dFormatManager::getFrameLayout(destFormat, width, height);
+    if(
+        !srcLayout.has_value() || !destLayout.has_value() ||
+        srcBuffer.size() < srcLayout->frameSize || destBuffer.size() < destLayout->frameSize
+    ) {
+        std::cerr << "Source or destination buffer is too small for the given image size" << "\n";
+        return G2dCpuConverterStatus::BUFFER_SIZE_ERROR;
+    }
+
+    std::optional<G2dRgbLayout> srcRgbLayout = getRgbLayout(srcFormat);
+    std::optional<G2dRgbLayout> destRgbLayout = getRgbLayout(destFormat);
+    if(srcRgbLayout.has_value() && destRgbLayout.has_value()) {
+        const size_t srcStride = width * srcRgbLayout->bytesPerPixel;
+        const size_t destStride = width * destRgbLayout->bytesPerPixel;
+        convertInBands(height, options, 0, [&](size_t firstRow, size_t lastRow, uint8_t*) {
+            // rows of RGB frames are contiguous, so a band is a single row
+            G2dCpuKernels::repackRgbRow(
+                srcBuffer.data() + (firstRow * srcStride),
+                *srcRgbLayout,
+                destBuffer.data() + (firstRow * destStride),
+                *destRgbLayout,
+                width * (lastRow - firstRow)
+            );
+        });
+        return G2dCpuConverterStatus::SUCCESS;
+    }
+
+    if(destFormat == OrqaG2dFormat::FMT_GRAY8) {
+        std::optional<YuvFrame> srcYuv;
+        if(!srcRgbLayout.has_value()) {
+            // the source frame is only ever read
+            srcYuv = YuvFrame {*getYuvFormatInfo(srcFormat), *srcLayout, const_cast<uint8_t*>(srcBuffer.data())};
+        }
+        convertInBands(height, options, 0, [&](size_t firstRow, size_t lastRow, uint8_t*) {
+            convertToGray(srcBuffer.data(), srcRgbLayout, srcYuv, destBuffer.data(), width, firstRow, lastRow);
+        });
+        return G2dCpuConverterStatus::SUCCESS;
+    }
+
+    const YuvFrame dest {*getYuvFormatInfo(destFormat), *destLayout, destBuffer.data()};
+    if(srcRgbLayout.has_value()) {
+        convertInBands(height, options, RgbToYuvScratchPerColumn * width, [&](size_t firstRow, size_t lastRow, uint8_t* scratch) {
+            convertRgbToYuv(srcBuffer.data(), *srcRgbLayout, dest, width, firstRow, lastRow, scratch);
+        });
+    }
+    else {
+        // the source frame is only ever read
+        const YuvFrame src {*getYuvFormatInfo(srcFormat), *srcLayout, const_cast<uint8_t*>(srcBuffer.data())};
+        convertInBands(height, options, YuvToYuvScratchPerColumn * width, [&](size_t firstRow, size_t lastRow, uint8_t* scratch) {
+            convertYuvToYuv(src, dest, width, firstRow, lastRow, scratch);
+        });
+    }
+
+    return G2dCpuConverterStatus::SUCCESS;
+}
+
+G2dCpuConverterStatus G2dCpuConverter::convertImage(
+    OrqaG2dFormat srcFormat,
+    std::span<const uint8_t> srcBuffer,
+    size_t width,
+    size_t height,
+    std::span<const G2dConversionOutput> outputs,
+    const G2dCpuConversionOptions& options
+)
+{
+    for(const G2dConversionOutput& output : outputs) {
+        if(output.width != width || output.height != height || !isConversionSupported(srcFormat, output.format, width, height)) {
+            std::cerr << "Unsupported CPU format conversion" << "\n";
+            return G2dCpuConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+        }
+        const std::optional<size_t> destSize = G2dFormatManager::getFrameSize(output.format, width, height);
+        if(!destSize.has_value() || output.buffer.size() < *destSize || !overlaysFit(output.overlays)) {
+            std::cerr << "Destination or overlay buffer is too small for the given image size" << "\n";
+            return G2dCpuConverterStatus::BUFFER_SIZE_ERROR;
+        }
+    }
+
+    const std::optional<G2dFrameLayout> srcLayout = G2dFormatManager::getFrameLayout(srcFormat, width, height);
+    if(!srcLayout.has_value() || srcBuffer.size() < srcLayout->frameSize) {
+        std::cerr << "Source buffer is too small for the given image size" << "\n";
+        return G2dCpuConverterStatus::BUFFER_SIZE_ERROR;
+    }
+
+    std::optional<G2dRgbLayout> srcRgbLayout = getRgbLayout(srcFormat);
+    std::optional<YuvFrame> srcYuv;
+    if(!srcRgbLayout.has_value()) {
+        // the source frame is only ever read
+        srcYuv = YuvFrame {*getYuvFormatInfo(srcFormat), *srcLayout, const_cast<uint8_t*>(srcBuffer.data())};
+    }
+
+    // first YUV output encoded from an RGB source, per chroma subsampling: 0 for 4:2:0, 1 for 4:2:2
+    std::optional<YuvFrame> encoded[2];
+    std::vector<std::function<void(size_t, size_t, uint8_t*)>> outputConverters;
+    outputConverters.reserve(outputs.size());
+
+    for(const G2dConversionOutput& output : outputs) {
+        std::optional<G2dRgbLayout> destRgbLayout = getRgbLayout(output.format);
+        if(destRgbLayout.has_value()) {
+            const size_t srcStride = width * srcRgbLayout->bytesPerPixel;
+            const size_t destStride = width * destRgbLayout->bytesPerPixel;
+            outputConverters.emplace_back([=, src = srcBuffer.data(), srcRgb = *srcRgbLayout, dest = output.buffer.data()](size_t firstRow, size_t lastRow, uint8_t*) {
+                G2dCpuKernels::repackRgbRow(src + (firstRow * srcStride), srcRgb, dest + (firstRow * destStride), *destRgbLayout, width * (lastRow - firstRow));
+                blendOverlaysIntoRgb(dest, *destRgbLayout, width, height, output.overlays, firstRow, lastRow);
+            });
+            continue;
+        }
+
+        if(output.format == OrqaG2dFormat::FMT_GRAY8) {
+            // luma of an RGB source is the same whether encoded alone or as part of a YUV output,
+            // so it is taken from an output already encoded when there is one
+            const bool reuseEncoded = srcRgbLayout.has_value() && (encoded[0].has_value() || encoded[1].has_value());
+            const std::optional<G2dRgbLayout> lumaRgbLayout = reuseEncoded ? std::nullopt : srcRgbLayout;
+            const std::optional<YuvFrame> lumaYuv = reuseEncoded ? (encoded[0].has_value() ? encoded[0] : encoded[1]) : srcYuv;
+            outputConverters.emplace_back([=, src = srcBuffer.data(), dest = output.buffer.data()](size_t firstRow, size_t lastRow, uint8_t*) {
+                convertToGray(src, lumaRgbLayout, lumaYuv, dest, width, firstRow, lastRow);
+                blendOverlaysIntoGray(dest, width, height, output.overlays, firstRow, lastRow);
+            });
+            continue;
+        }
+
+        // the layouts of all outputs were checked above
+        const YuvFrame dest {*getYuvFormatInfo(output.format), *G2dFormatManager::getFrameLayout(output.format, width, height), output.buffer.data()};
+        if(srcYuv.has_value()) {
+            outputConverters.emplace_back([=, src = *srcYuv](size_t firstRow, size_t lastRow, uint8_t* scratch) {
+                convertYuvToYuv(src, dest, width, firstRow, lastRow, scratch);
+                blendOverlaysIntoYuv(dest, width, height, output.overlays, firstRow, lastRow);
+            });
+            continue;
+        }
+
+        // repacking the band already encoded is exact and much cheaper than encoding it again,
+        // as long as the encoded band carries no overlays of its own
+        std::optional<YuvFrame>& shared = encoded[dest.info.chromaVerticalSubsampling == 2 ? 0 : 1];
+        if(shared.has_value()) {
+            outputConverters.emplace_back([=, src = *shared](size_t firstRow, size_t lastRow, uint8_t* scratch) {
+                convertYuvToYuv(src, dest, width, firstRow, lastRow, scratch);
+                blendOverlaysIntoYuv(dest, width, height, output.overlays, firstRow, lastRow);
+            });
+            continue;
+        }
+        if(output.overlays.empty()) {
+            shared = dest;
+        }
+        outputConverters.emplace_back([=, src = srcBuffer.data(), srcRgb = *srcRgbLayout](size_t firstRow, size_t lastRow, uint8_t* scratch) {
+            convertRgbToYuv(src, srcRgb, dest, width, firstRow, lastRow, scratch);
+            blendOverlaysIntoYuv(dest, width, height, output.overlays, firstRow, lastRow);
+        });
+    }
+
+    G2dCpuConversionOptions bandOptions = options;
+    if(bandOptions.bandRows == 0) {
+        bandOptions.bandRows = MultiOutputBandRows;
+    }
+    // every output converter of a band runs on the same thread, one after another, so they share its scratch
+    convertInBands(height, bandOptions, YuvToYuvScratchPerColumn * width, [&](size_t firstRow, size_t lastRow, uint8_t* scratch) {
+        for(const std::function<void(size_t, size_t, uint8_t*)>& convertRows : outputConverters) {
+            convertRows(firstRow, lastRow, scratch);
+        }
+    });
+
+    return G2dCpuConverterStatus::SUCCESS;
+}
+
+G2dCpuConverterStatus G2dCpuConverter::blendOverlays(
+    OrqaG2dFormat format,
+    std::span<uint8_t> buffer,
+    size_t width,
+    size_t height,
+    std::span<const G2dOverlayLayer> overlays
+)
+{
+    std::optional<G2dRgbLayout> rgbLayout = getRgbLayout(format);
+    std::optional<YuvFormatInfo> yuvInfo = getYuvFormatInfo(format);
+    const bool gray = format == OrqaG2dFormat::FMT_GRAY8;
+    if(!rgbLayout.has_value() && !gray && (!yuvInfo.has_value() || width % 2 != 0 || height % 2 != 0)) {
+        std::cerr << "Unsupported CPU overlay format" << "\n";
+        return G2dCpuConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+    }
+
+    const std::optional<G2dFrameLayout> layout = G2dFormatManager::getFrameLayout(format, width, height);
+    if(!layout.has_value() || buffer.size() < layout->frameSize || !overlaysFit(overlays)) {
+        std::cerr << "Frame or overlay buffer is too small for the given image size" << "\n";
+        return G2dCpuConverterStatus::BUFFER_SIZE_ERROR;
+    }
+
+    if(rgbLayout.has_value()) {
+        blendOverlaysIntoRgb(buffer.data(), *rgbLayout, width, height, overlays, 0, height);
+    }
+    else if(gray) {
+        blendOverlaysIntoGray(buffer.data(), width, height, overlays, 0, height);
+    }
+    else {
+        blendOverlaysIntoYuv(YuvFrame {*yuvInfo, *layout, buffer.data()}, width, height, overlays, 0, height);
+    }
+    return G2dCpuConverterStatus::SUCCESS;
+}
+
+bool G2dCpuConverter::isInPlaceConversionSupported(OrqaG2dFormat srcFormat, OrqaG2dFormat destFormat, size_t width, size_t height) {
+    if(srcFormat == destFormat || width == 0 || height == 0) {
+        return false;
+    }
+
+    std::optional<G2dRgbLayout> srcRgbLayout = getRgbLayout(srcFormat);
+    std::optional<G2dRgbLayout> destRgbLayout = getRgbLayout(destFormat);
+    if(srcRgbLayout.has_value() && destRgbLayout.has_value()) {
+        return srcRgbLayout->bytesPerPixel == destRgbLayout->bytesPerPixel;
+    }
+
+    std::optional<YuvFormatInfo> srcYuvInfo = getYuvFormatInfo(srcFormat);
+    std::optional<YuvFormatInfo> destYuvInfo = getYuvFormatInfo(destFormat);
+    if(!srcYuvInfo.has_value() || !destYuvInfo.has_value() || width % 2 != 0 || height % 2 != 0) {
+        return false;
+    }
+    return srcYuvInfo->storage == destYuvInfo->storage &&
+        srcYuvInfo->chromaVerticalSubsampling == destYuvInfo->chromaVerticalSubsampling;
+}
+
+G2dCpuConverterStatus G2dCpuConverter::convertImageInPlace(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    std::span<uint8_t> buffer,
+    size_t width,
+    size_t height
+)
+{
+    if(!isInPlaceConversionSupported(srcFormat, destFormat, width, height)) {
+        std::cerr << "Unsupported in place format conversion" << "\n";
+        return G2dCpuConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+    }
+
+    const std::optional<G2dFrameLayout> layout = G2dFormatManager::getFrameLayout(srcFormat, width, height);
+    if(!layout.has_value() || buffer.size() < layout->frameSize) {
+        std::cerr << "Buffer is too small for the given image size" << "\n";
+        return G2dCpuConverterStatus::BUFFER_SIZE_ERROR;
+    }
+
+    // every kernel reads a block of the frame before it writes the same block back
+    std::optional<G2dRgbLayout> srcRgbLayout = getRgbLayout(srcFormat);
+    if(srcRgbLayout.has_value()) {
+        G2dCpuKernels::repackRgbRow(buffer.data(), *srcRgbLayout, buffer.data(), *getRgbLayout(destFormat), width * height);
+        return G2dCpuConverterStatus::SUCCESS;
+    }
+
+    const YuvFormatInfo srcInfo = *getYuvFormatInfo(srcFormat);
+    const YuvFormatInfo destInfo = *getYuvFormatInfo(destFormat);
+    if(srcInfo.storage == YuvStorage::PACKED) {
+        G2dCpuKernels::reorderPacked422Row(buffer.data(), srcInfo.order, buffer.data(), destInfo.order, width * height);
+    }
+    else if(srcInfo.vFirst != destInfo.vFirst) {
+        // same storage and subsampling, so only the order of U and V differs
+        uint8_t* first = buffer.data() + layout->planes[1].offset;
+        if(srcInfo.storage == YuvStorage::SEMI_PLANAR) {
+            G2dCpuKernels::swapInterleavedRow(first, first, (layout->planes[1].stride * layout->planes[1].rows) / 2);
+        }
+        else {
+            std::swap_ranges(first, first + (layout->planes[1].stride * layout->planes[1].rows), buffer.data() + layout->planes[2].offset);
+        }
+    }
+
+    return G2dCpuConverterStatus::SUCCESS;
+}
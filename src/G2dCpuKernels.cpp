@@ -0,0 +1,691 @@
+#include "G2dCpuKernels.hpp"
+
+#include <cstring>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define G2D_CPU_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// BT.601 limited range coefficients in 8 bit fixed point
+constexpr int LumaR = 66;
+constexpr int LumaG = 129;
+constexpr int LumaB = 25;
+constexpr int CbR = -38;
+constexpr int CbG = -74;
+constexpr int CbB = 112;
+constexpr int CrR = 112;
+constexpr int CrG = -94;
+constexpr int CrB = -18;
+
+struct RgbPixel {
+    int r;
+    int g;
+    int b;
+    int a;
+};
+
+/// @brief Expands a 5 bit channel to 8 bits
+inline int expand5(int value) {
+    return (value << 3) | (value >> 2);
+}
+
+/// @brief Expands a 6 bit channel to 8 bits
+inline int expand6(int value) {
+    return (value << 2) | (value >> 4);
+}
+
+inline RgbPixel loadRgbPixel(const uint8_t* rgb, const G2dRgbLayout& layout, size_t x) {
+    const uint8_t* pixel = rgb + (x * layout.bytesPerPixel);
+    if(layout.packing == G2dRgbPacking::BYTES) {
+        return {pixel[layout.r], pixel[layout.g], pixel[layout.b], layout.hasAlpha ? pixel[layout.a] : 0xFF};
+    }
+
+    const int word = pixel[0] | (pixel[1] << 8);
+    if(layout.packing == G2dRgbPacking::RGB565) {
+        return {expand5((word >> 11) & 0x1F), expand6((word >> 5) & 0x3F), expand5(word & 0x1F), 0xFF};
+    }
+    return {
+        expand5((word >> 11) & 0x1F),
+        expand5((word >> 6) & 0x1F),
+        expand5((word >> 1) & 0x1F),
+        (layout.hasAlpha && (word & 1) == 0) ? 0 : 0xFF
+    };
+}
+
+inline void storeRgbPixel(uint8_t* rgb, const G2dRgbLayout& layout, size_t x, const RgbPixel& value) {
+    uint8_t* pixel = rgb + (x * layout.bytesPerPixel);
+    if(layout.packing == G2dRgbPacking::BYTES) {
+        pixel[layout.r] = static_cast<uint8_t>(value.r);
+        pixel[layout.g] = static_cast<uint8_t>(value.g);
+        pixel[layout.b] = static_cast<uint8_t>(value.b);
+        if(layout.bytesPerPixel == 4) {
+            pixel[layout.a] = layout.hasAlpha ? static_cast<uint8_t>(value.a) : 0xFF;
+        }
+        return;
+    }
+
+    int word = 0;
+    if(layout.packing == G2dRgbPacking::RGB565) {
+        word = ((value.r >> 3) << 11) | ((value.g >> 2) << 5) | (value.b >> 3);
+    }
+    else {
+        word = ((value.r >> 3) << 11) | ((value.g >> 3) << 6) | ((value.b >> 3) << 1) | (layout.hasAlpha ? (value.a >> 7) : 1);
+    }
+    pixel[0] = static_cast<uint8_t>(word);
+    pixel[1] = static_cast<uint8_t>(word >> 8);
+}
+
+/// @brief Byte shuffle turning a 4 byte RGB pixel into another 4 byte RGB pixel
+/// Destination byte i of every group of four is source byte index[i], or fill[i] when index[i] is out of range.
+struct ByteShuffle {
+    uint8_t index[16];
+    uint8_t fill[16];
+};
+
+ByteShuffle makeByteShuffle(const G2dRgbLayout& srcLayout, const G2dRgbLayout& destLayout) {
+    ByteShuffle shuffle {};
+    for(uint8_t pixel = 0; pixel < 4; pixel++) {
+        const uint8_t base = pixel * 4;
+        for(uint8_t i = 0; i < 4; i++) {
+            shuffle.index[base + i] = 0xFF;
+            shuffle.fill[base + i] = 0xFF;
+        }
+        shuffle.index[base + destLayout.r] = base + srcLayout.r;
+        shuffle.index[base + destLayout.g] = base + srcLayout.g;
+        shuffle.index[base + destLayout.b] = base + srcLayout.b;
+        shuffle.fill[base + destLayout.r] = 0;
+        shuffle.fill[base + destLayout.g] = 0;
+        shuffle.fill[base + destLayout.b] = 0;
+        if(destLayout.hasAlpha && srcLayout.hasAlpha) {
+            shuffle.index[base + destLayout.a] = base + srcLayout.a;
+            shuffle.fill[base + destLayout.a] = 0;
+        }
+    }
+    return shuffle;
+}
+
+inline uint8_t luma(const RgbPixel& pixel) {
+    return static_cast<uint8_t>((((LumaR * pixel.r) + (LumaG * pixel.g) + (LumaB * pixel.b) + 128) >> 8) + 16);
+}
+
+inline uint8_t chroma(int r, int g, int b, int cr, int cg, int cb) {
+    return static_cast<uint8_t>((((cr * r) + (cg * g) + (cb * b) + 128) >> 8) + 128);
+}
+
+/// @brief Divides a product of two 8 bit values by 255, rounding to nearest
+inline int div255(int value) {
+    return (value + 128 + ((value + 128) >> 8)) >> 8;
+}
+
+/// @brief Blends an 8 bit sample over another with the given coverage
+inline uint8_t blendSample(int dest, int src, int alpha) {
+    return static_cast<uint8_t>(div255((dest * (255 - alpha)) + (src * alpha)));
+}
+
+#if defined(G2D_CPU_KERNELS_NEON)
+/// @brief Expands 5 bit channels to 8 bits
+inline uint8x8_t expand5x8(uint16x8_t value) {
+    return vmovn_u16(vorrq_u16(vshlq_n_u16(value, 3), vshrq_n_u16(value, 2)));
+}
+
+/// @brief Expands 16 bit pixels to 8 bit channels
+inline uint8x16x4_t expandPacked16(uint16x8_t low, uint16x8_t high, const G2dRgbLayout& layout) {
+    const bool is565 = layout.packing == G2dRgbPacking::RGB565;
+    const uint16x8_t words[2] = {low, high};
+    uint8x8_t channels[4][2];
+    for(size_t half = 0; half < 2; half++) {
+        const uint16x8_t r = vshrq_n_u16(words[half], 11);
+        const uint16x8_t g = is565 ?
+            vandq_u16(vshrq_n_u16(words[half], 5), vdupq_n_u16(0x3F)) :
+            vandq_u16(vshrq_n_u16(words[half], 6), vdupq_n_u16(0x1F));
+        const uint16x8_t b = is565 ?
+            vandq_u16(words[half], vdupq_n_u16(0x1F)) :
+            vandq_u16(vshrq_n_u16(words[half], 1), vdupq_n_u16(0x1F));
+
+        channels[0][half] = expand5x8(r);
+        channels[1][half] = is565 ? vmovn_u16(vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4))) : expand5x8(g);
+        channels[2][half] = expand5x8(b);
+        channels[3][half] = (layout.hasAlpha && !is565) ?
+            vmovn_u16(vtstq_u16(words[half], vdupq_n_u16(1))) :
+            vdup_n_u8(0xFF);
+    }
+    return {{
+        vcombine_u8(channels[0][0], channels[0][1]),
+        vcombine_u8(channels[1][0], channels[1][1]),
+        vcombine_u8(channels[2][0], channels[2][1]),
+        vcombine_u8(channels[3][0], channels[3][1])
+    }};
+}
+
+/// @brief Loads 16 RGB pixels as planar 8 bit R, G, B and A vectors
+inline uint8x16x4_t loadRgba16(const uint8_t* rgb, const G2dRgbLayout& layout) {
+    if(layout.packing != G2dRgbPacking::BYTES) {
+        return expandPacked16(vreinterpretq_u16_u8(vld1q_u8(rgb)), vreinterpretq_u16_u8(vld1q_u8(rgb + 16)), layout);
+    }
+    if(layout.bytesPerPixel == 3) {
+        const uint8x16x3_t pixels = vld3q_u8(rgb);
+        return {{pixels.val[layout.r], pixels.val[layout.g], pixels.val[layout.b], vdupq_n_u8(0xFF)}};
+    }
+    const uint8x16x4_t pixels = vld4q_u8(rgb);
+    return {{
+        pixels.val[layout.r],
+        pixels.val[layout.g],
+        pixels.val[layout.b],
+        layout.hasAlpha ? pixels.val[layout.a] : vdupq_n_u8(0xFF)
+    }};
+}
+
+/// @brief Packs 8 pixels of 8 bit channels into 16 bit pixels
+inline uint16x8_t packPacked16(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a, const G2dRgbLayout& layout) {
+    const uint16x8_t red = vshlq_n_u16(vmovl_u8(vshr_n_u8(r, 3)), 11);
+    if(layout.packing == G2dRgbPacking::RGB565) {
+        const uint16x8_t green = vshlq_n_u16(vmovl_u8(vshr_n_u8(g, 2)), 5);
+        return vorrq_u16(vorrq_u16(red, green), vmovl_u8(vshr_n_u8(b, 3)));
+    }
+    const uint16x8_t green = vshlq_n_u16(vmovl_u8(vshr_n_u8(g, 3)), 6);
+    const uint16x8_t blue = vshlq_n_u16(vmovl_u8(vshr_n_u8(b, 3)), 1);
+    const uint16x8_t alpha = layout.hasAlpha ? vmovl_u8(vshr_n_u8(a, 7)) : vdupq_n_u16(1);
+    return vorrq_u16(vorrq_u16(red, green), vorrq_u16(blue, alpha));
+}
+
+/// @brief Stores 16 pixels given as planar 8 bit R, G, B and A vectors
+inline void storeRgba16(uint8_t* rgb, const G2dRgbLayout& layout, const uint8x16x4_t& channels) {
+    if(layout.packing != G2dRgbPacking::BYTES) {
+        const uint16x8_t low = packPacked16(
+            vget_low_u8(channels.val[0]),
+            vget_low_u8(channels.val[1]),
+            vget_low_u8(channels.val[2]),
+            vget_low_u8(channels.val[3]),
+            layout
+        );
+        const uint16x8_t high = packPacked16(
+            vget_high_u8(channels.val[0]),
+            vget_high_u8(channels.val[1]),
+            vget_high_u8(channels.val[2]),
+            vget_high_u8(channels.val[3]),
+            layout
+        );
+        vst1q_u8(rgb, vreinterpretq_u8_u16(low));
+        vst1q_u8(rgb + 16, vreinterpretq_u8_u16(high));
+        return;
+    }
+    if(layout.bytesPerPixel == 3) {
+        uint8x16x3_t pixels;
+        pixels.val[layout.r] = channels.val[0];
+        pixels.val[layout.g] = channels.val[1];
+        pixels.val[layout.b] = channels.val[2];
+        vst3q_u8(rgb, pixels);
+        return;
+    }
+    uint8x16x4_t pixels;
+    pixels.val[layout.r] = channels.val[0];
+    pixels.val[layout.g] = channels.val[1];
+    pixels.val[layout.b] = channels.val[2];
+    pixels.val[layout.a] = layout.hasAlpha ? channels.val[3] : vdupq_n_u8(0xFF);
+    vst4q_u8(rgb, pixels);
+}
+
+inline uint8x8_t lumaHalf(uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+    uint16x8_t sum = vmull_u8(r, vdup_n_u8(LumaR));
+    sum = vmlal_u8(sum, g, vdup_n_u8(LumaG));
+    sum = vmlal_u8(sum, b, vdup_n_u8(LumaB));
+    return vadd_u8(vshrn_n_u16(vaddq_u16(sum, vdupq_n_u16(128)), 8), vdup_n_u8(16));
+}
+
+inline uint8x16_t luma16(const uint8x16x4_t& rgb) {
+    return vcombine_u8(
+        lumaHalf(vget_low_u8(rgb.val[0]), vget_low_u8(rgb.val[1]), vget_low_u8(rgb.val[2])),
+        lumaHalf(vget_high_u8(rgb.val[0]), vget_high_u8(rgb.val[1]), vget_high_u8(rgb.val[2]))
+    );
+}
+
+/// @brief Divides 16 bit products of two 8 bit values by 255, rounding to nearest
+inline uint8x8_t div255x8(uint16x8_t value) {
+    return vraddhn_u16(value, vrshrq_n_u16(value, 8));
+}
+
+/// @brief Blends 16 samples over others with the given coverage
+inline uint8x16_t blend16(uint8x16_t dest, uint8x16_t src, uint8x16_t alpha) {
+    const uint8x16_t inverse = vmvnq_u8(alpha);
+    const uint16x8_t low = vmlal_u8(vmull_u8(vget_low_u8(dest), vget_low_u8(inverse)), vget_low_u8(src), vget_low_u8(alpha));
+    const uint16x8_t high = vmlal_u8(vmull_u8(vget_high_u8(dest), vget_high_u8(inverse)), vget_high_u8(src), vget_high_u8(alpha));
+    return vcombine_u8(div255x8(low), div255x8(high));
+}
+
+/// @brief Scales 16 alpha samples by a global alpha
+inline uint8x16_t scaleAlpha16(uint8x16_t alpha, uint8x8_t globalAlpha) {
+    return vcombine_u8(
+        div255x8(vmull_u8(vget_low_u8(alpha), globalAlpha)),
+        div255x8(vmull_u8(vget_high_u8(alpha), globalAlpha))
+    );
+}
+
+/// @brief Computes 8 chroma samples from averaged channels in the 0-255 range
+inline uint8x8_t chroma8(uint16x8_t r, uint16x8_t g, uint16x8_t b, int16_t cr, int16_t cg, int16_t cb) {
+    int16x8_t sum = vmulq_n_s16(vreinterpretq_s16_u16(r), cr);
+    sum = vmlaq_n_s16(sum, vreinterpretq_s16_u16(g), cg);
+    sum = vmlaq_n_s16(sum, vreinterpretq_s16_u16(b), cb);
+    sum = vaddq_s16(vshrq_n_s16(vaddq_s16(sum, vdupq_n_s16(128)), 8), vdupq_n_s16(128));
+    return vqmovun_s16(sum);
+}
+#endif
+
+}
+
+bool G2dCpuKernels::regionsEqual(const uint8_t* a, const uint8_t* b, size_t stride, size_t rowBytes, size_t rows) {
+    for(size_t row = 0; row < rows; row++) {
+        const uint8_t* rowA = a + (row * stride);
+        const uint8_t* rowB = b + (row * stride);
+        size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+        uint8x16_t difference = vdupq_n_u8(0);
+        for(; x + 16 <= rowBytes; x += 16) {
+            difference = vorrq_u8(difference, veorq_u8(vld1q_u8(rowA + x), vld1q_u8(rowB + x)));
+        }
+        if(vmaxvq_u8(difference) != 0) {
+            return false;
+        }
+#endif
+        if(std::memcmp(rowA + x, rowB + x, rowBytes - x) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void G2dCpuKernels::interleaveRow(const uint8_t* a, const uint8_t* b, uint8_t* dest, size_t count) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= count; x += 16) {
+        const uint8x16x2_t pair = {{vld1q_u8(a + x), vld1q_u8(b + x)}};
+        vst2q_u8(dest + (2 * x), pair);
+    }
+#endif
+    for(; x < count; x++) {
+        dest[2 * x] = a[x];
+        dest[(2 * x) + 1] = b[x];
+    }
+}
+
+void G2dCpuKernels::deinterleaveRow(const uint8_t* src, uint8_t* a, uint8_t* b, size_t count) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= count; x += 16) {
+        const uint8x16x2_t pair = vld2q_u8(src + (2 * x));
+        vst1q_u8(a + x, pair.val[0]);
+        vst1q_u8(b + x, pair.val[1]);
+    }
+#endif
+    for(; x < count; x++) {
+        a[x] = src[2 * x];
+        b[x] = src[(2 * x) + 1];
+    }
+}
+
+void G2dCpuKernels::averageRows(const uint8_t* a, const uint8_t* b, uint8_t* dest, size_t count) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= count; x += 16) {
+        vst1q_u8(dest + x, vrhaddq_u8(vld1q_u8(a + x), vld1q_u8(b + x)));
+    }
+#endif
+    for(; x < count; x++) {
+        dest[x] = static_cast<uint8_t>((a[x] + b[x] + 1) >> 1);
+    }
+}
+
+void G2dCpuKernels::downsampleRows2x2(const uint8_t* a, const uint8_t* b, uint8_t* dest, size_t count) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= count; x += 16) {
+        const uint16x8_t low = vaddq_u16(vpaddlq_u8(vld1q_u8(a + (2 * x))), vpaddlq_u8(vld1q_u8(b + (2 * x))));
+        const uint16x8_t high = vaddq_u16(vpaddlq_u8(vld1q_u8(a + (2 * x) + 16)), vpaddlq_u8(vld1q_u8(b + (2 * x) + 16)));
+        vst1q_u8(dest + x, vcombine_u8(vrshrn_n_u16(low, 2), vrshrn_n_u16(high, 2)));
+    }
+#endif
+    for(; x < count; x++) {
+        dest[x] = static_cast<uint8_t>((a[2 * x] + a[(2 * x) + 1] + b[2 * x] + b[(2 * x) + 1] + 2) >> 2);
+    }
+}
+
+void G2dCpuKernels::unpackPacked422Row(
+    const uint8_t* src,
+    G2dPackedYuvOrder order,
+    uint8_t* y,
+    uint8_t* u,
+    uint8_t* v,
+    size_t width
+)
+{
+    const size_t pairs = width / 2;
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= pairs; x += 16) {
+        const uint8x16x4_t macropixels = vld4q_u8(src + (4 * x));
+        const uint8x16x2_t luma = {{macropixels.val[order.y0], macropixels.val[order.y1]}};
+        vst2q_u8(y + (2 * x), luma);
+        vst1q_u8(u + x, macropixels.val[order.u]);
+        vst1q_u8(v + x, macropixels.val[order.v]);
+    }
+#endif
+    for(; x < pairs; x++) {
+        const uint8_t* macropixel = src + (4 * x);
+        y[2 * x] = macropixel[order.y0];
+        y[(2 * x) + 1] = macropixel[order.y1];
+        u[x] = macropixel[order.u];
+        v[x] = macropixel[order.v];
+    }
+}
+
+void G2dCpuKernels::extractPacked422LumaRow(const uint8_t* src, G2dPackedYuvOrder order, uint8_t* y, size_t width) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    // both luma samples of a macropixel sit at the same parity
+    const size_t parity = order.y0 & 1;
+    for(; x + 16 <= width; x += 16) {
+        vst1q_u8(y + x, vld2q_u8(src + (2 * x)).val[parity]);
+    }
+#endif
+    for(; x < width; x += 2) {
+        const uint8_t* macropixel = src + (2 * x);
+        y[x] = macropixel[order.y0];
+        y[x + 1] = macropixel[order.y1];
+    }
+}
+
+void G2dCpuKernels::packPacked422Row(
+    const uint8_t* y,
+    const uint8_t* u,
+    const uint8_t* v,
+    G2dPackedYuvOrder order,
+    uint8_t* dest,
+    size_t width
+)
+{
+    const size_t pairs = width / 2;
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= pairs; x += 16) {
+        const uint8x16x2_t luma = vld2q_u8(y + (2 * x));
+        uint8x16x4_t macropixels;
+        macropixels.val[order.y0] = luma.val[0];
+        macropixels.val[order.y1] = luma.val[1];
+        macropixels.val[order.u] = vld1q_u8(u + x);
+        macropixels.val[order.v] = vld1q_u8(v + x);
+        vst4q_u8(dest + (4 * x), macropixels);
+    }
+#endif
+    for(; x < pairs; x++) {
+        uint8_t* macropixel = dest + (4 * x);
+        macropixel[order.y0] = y[2 * x];
+        macropixel[order.y1] = y[(2 * x) + 1];
+        macropixel[order.u] = u[x];
+        macropixel[order.v] = v[x];
+    }
+}
+
+void G2dCpuKernels::reorderPacked422Row(
+    const uint8_t* src,
+    G2dPackedYuvOrder srcOrder,
+    uint8_t* dest,
+    G2dPackedYuvOrder destOrder,
+    size_t width
+)
+{
+    // source byte feeding each destination byte of a macropixel
+    uint8_t pattern[4];
+    pattern[destOrder.y0] = srcOrder.y0;
+    pattern[destOrder.u] = srcOrder.u;
+    pattern[destOrder.y1] = srcOrder.y1;
+    pattern[destOrder.v] = srcOrder.v;
+
+    const size_t pairs = width / 2;
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    uint8_t indices[16];
+    for(uint8_t i = 0; i < 16; i++) {
+        indices[i] = static_cast<uint8_t>((i & ~3) + pattern[i & 3]);
+    }
+    const uint8x16_t index = vld1q_u8(indices);
+    for(; x + 4 <= pairs; x += 4) {
+        vst1q_u8(dest + (4 * x), vqtbl1q_u8(vld1q_u8(src + (4 * x)), index));
+    }
+#endif
+    for(; x < pairs; x++) {
+        const uint8_t* srcMacropixel = src + (4 * x);
+        const uint8_t samples[4] = {srcMacropixel[0], srcMacropixel[1], srcMacropixel[2], srcMacropixel[3]};
+        uint8_t* destMacropixel = dest + (4 * x);
+        for(size_t i = 0; i < 4; i++) {
+            destMacropixel[i] = samples[pattern[i]];
+        }
+    }
+}
+
+void G2dCpuKernels::swapInterleavedRow(const uint8_t* src, uint8_t* dest, size_t count) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 8 <= count; x += 8) {
+        vst1q_u8(dest + (2 * x), vrev16q_u8(vld1q_u8(src + (2 * x))));
+    }
+#endif
+    for(; x < count; x++) {
+        const uint8_t a = src[2 * x];
+        dest[2 * x] = src[(2 * x) + 1];
+        dest[(2 * x) + 1] = a;
+    }
+}
+
+void G2dCpuKernels::rgbRowsToYuv420(
+    const uint8_t* rgb0,
+    const uint8_t* rgb1,
+    const G2dRgbLayout& layout,
+    uint8_t* y0,
+    uint8_t* y1,
+    uint8_t* u,
+    uint8_t* v,
+    size_t width
+)
+{
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= width; x += 16) {
+        const uint8x16x4_t top = loadRgba16(rgb0 + (x * layout.bytesPerPixel), layout);
+        const uint8x16x4_t bottom = loadRgba16(rgb1 + (x * layout.bytesPerPixel), layout);
+        vst1q_u8(y0 + x, luma16(top));
+        vst1q_u8(y1 + x, luma16(bottom));
+
+        // rounded average of every 2x2 block
+        const uint16x8_t r = vrshrq_n_u16(vaddq_u16(vpaddlq_u8(top.val[0]), vpaddlq_u8(bottom.val[0])), 2);
+        const uint16x8_t g = vrshrq_n_u16(vaddq_u16(vpaddlq_u8(top.val[1]), vpaddlq_u8(bottom.val[1])), 2);
+        const uint16x8_t b = vrshrq_n_u16(vaddq_u16(vpaddlq_u8(top.val[2]), vpaddlq_u8(bottom.val[2])), 2);
+        vst1_u8(u + (x / 2), chroma8(r, g, b, CbR, CbG, CbB));
+        vst1_u8(v + (x / 2), chroma8(r, g, b, CrR, CrG, CrB));
+    }
+#endif
+    for(; x < width; x += 2) {
+        const RgbPixel pixels[4] = {
+            loadRgbPixel(rgb0, layout, x),
+            loadRgbPixel(rgb0, layout, x + 1),
+            loadRgbPixel(rgb1, layout, x),
+            loadRgbPixel(rgb1, layout, x + 1)
+        };
+        y0[x] = luma(pixels[0]);
+        y0[x + 1] = luma(pixels[1]);
+        y1[x] = luma(pixels[2]);
+        y1[x + 1] = luma(pixels[3]);
+
+        const int r = (pixels[0].r + pixels[1].r + pixels[2].r + pixels[3].r + 2) >> 2;
+        const int g = (pixels[0].g + pixels[1].g + pixels[2].g + pixels[3].g + 2) >> 2;
+        const int b = (pixels[0].b + pixels[1].b + pixels[2].b + pixels[3].b + 2) >> 2;
+        u[x / 2] = chroma(r, g, b, CbR, CbG, CbB);
+        v[x / 2] = chroma(r, g, b, CrR, CrG, CrB);
+    }
+}
+
+void G2dCpuKernels::rgbRowToYuv422(const uint8_t* rgb, const G2dRgbLayout& layout, uint8_t* y, uint8_t* u, uint8_t* v, size_t width) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= width; x += 16) {
+        const uint8x16x4_t pixels = loadRgba16(rgb + (x * layout.bytesPerPixel), layout);
+        vst1q_u8(y + x, luma16(pixels));
+
+        // rounded average of every pair of pixels
+        const uint16x8_t r = vrshrq_n_u16(vpaddlq_u8(pixels.val[0]), 1);
+        const uint16x8_t g = vrshrq_n_u16(vpaddlq_u8(pixels.val[1]), 1);
+        const uint16x8_t b = vrshrq_n_u16(vpaddlq_u8(pixels.val[2]), 1);
+        vst1_u8(u + (x / 2), chroma8(r, g, b, CbR, CbG, CbB));
+        vst1_u8(v + (x / 2), chroma8(r, g, b, CrR, CrG, CrB));
+    }
+#endif
+    for(; x < width; x += 2) {
+        const RgbPixel first = loadRgbPixel(rgb, layout, x);
+        const RgbPixel second = loadRgbPixel(rgb, layout, x + 1);
+        y[x] = luma(first);
+        y[x + 1] = luma(second);
+
+        const int r = (first.r + second.r + 1) >> 1;
+        const int g = (first.g + second.g + 1) >> 1;
+        const int b = (first.b + second.b + 1) >> 1;
+        u[x / 2] = chroma(r, g, b, CbR, CbG, CbB);
+        v[x / 2] = chroma(r, g, b, CrR, CrG, CrB);
+    }
+}
+
+void G2dCpuKernels::rgbRowToLuma(const uint8_t* rgb, const G2dRgbLayout& layout, uint8_t* y, size_t width) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= width; x += 16) {
+        vst1q_u8(y + x, luma16(loadRgba16(rgb + (x * layout.bytesPerPixel), layout)));
+    }
+#endif
+    for(; x < width; x++) {
+        y[x] = luma(loadRgbPixel(rgb, layout, x));
+    }
+}
+
+void G2dCpuKernels::repackRgbRow(
+    const uint8_t* src,
+    const G2dRgbLayout& srcLayout,
+    uint8_t* dest,
+    const G2dRgbLayout& destLayout,
+    size_t width
+)
+{
+    size_t x = 0;
+    if(
+        srcLayout.packing == G2dRgbPacking::BYTES && srcLayout.bytesPerPixel == 4 &&
+        destLayout.packing == G2dRgbPacking::BYTES && destLayout.bytesPerPixel == 4
+    ) {
+        // reordering channels within 32 bit pixels is a single table lookup
+        const ByteShuffle shuffle = makeByteShuffle(srcLayout, destLayout);
+#if defined(G2D_CPU_KERNELS_NEON)
+        const uint8x16_t index = vld1q_u8(shuffle.index);
+        const uint8x16_t fill = vld1q_u8(shuffle.fill);
+        for(; x + 4 <= width; x += 4) {
+            vst1q_u8(dest + (4 * x), vorrq_u8(vqtbl1q_u8(vld1q_u8(src + (4 * x)), index), fill));
+        }
+#endif
+        for(; x < width; x++) {
+            const uint8_t* srcPixel = src + (4 * x);
+            const uint8_t channels[4] = {srcPixel[0], srcPixel[1], srcPixel[2], srcPixel[3]};
+            uint8_t* destPixel = dest + (4 * x);
+            for(size_t i = 0; i < 4; i++) {
+                destPixel[i] = shuffle.index[i] < 4 ? channels[shuffle.index[i]] : shuffle.fill[i];
+            }
+        }
+        return;
+    }
+
+#if defined(G2D_CPU_KERNELS_NEON)
+    for(; x + 16 <= width; x += 16) {
+        storeRgba16(dest + (x * destLayout.bytesPerPixel), destLayout, loadRgba16(src + (x * srcLayout.bytesPerPixel), srcLayout));
+    }
+#endif
+    for(; x < width; x++) {
+        storeRgbPixel(dest, destLayout, x, loadRgbPixel(src, srcLayout, x));
+    }
+}
+
+void G2dCpuKernels::blendRgbaRow(const uint8_t* overlay, uint8_t globalAlpha, uint8_t* dest, const G2dRgbLayout& destLayout, size_t width) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    const uint8x8_t global = vdup_n_u8(globalAlpha);
+    for(; x + 16 <= width; x += 16) {
+        const uint8x16x4_t src = vld4q_u8(overlay + (4 * x));
+        uint8x16x4_t pixels = loadRgba16(dest + (x * destLayout.bytesPerPixel), destLayout);
+        const uint8x16_t alpha = scaleAlpha16(src.val[3], global);
+        pixels.val[0] = blend16(pixels.val[0], src.val[0], alpha);
+        pixels.val[1] = blend16(pixels.val[1], src.val[1], alpha);
+        pixels.val[2] = blend16(pixels.val[2], src.val[2], alpha);
+        pixels.val[3] = blend16(pixels.val[3], vdupq_n_u8(0xFF), alpha);
+        storeRgba16(dest + (x * destLayout.bytesPerPixel), destLayout, pixels);
+    }
+#endif
+    for(; x < width; x++) {
+        const uint8_t* src = overlay + (4 * x);
+        const int alpha = div255(src[3] * globalAlpha);
+        RgbPixel pixel = loadRgbPixel(dest, destLayout, x);
+        pixel.r = blendSample(pixel.r, src[0], alpha);
+        pixel.g = blendSample(pixel.g, src[1], alpha);
+        pixel.b = blendSample(pixel.b, src[2], alpha);
+        pixel.a = blendSample(pixel.a, 0xFF, alpha);
+        storeRgbPixel(dest, destLayout, x, pixel);
+    }
+}
+
+void G2dCpuKernels::blendRgbaRowIntoLuma(const uint8_t* overlay, uint8_t globalAlpha, uint8_t* y, size_t step, size_t width) {
+    size_t x = 0;
+#if defined(G2D_CPU_KERNELS_NEON)
+    const uint8x8_t global = vdup_n_u8(globalAlpha);
+    // packed luma may start at the second byte of a macropixel, so 2 * 16 bytes from it would pass the
+    // end of the row on the last block
+    for(; x + 16 + (step - 1) <= width; x += 16) {
+        const uint8x16x4_t src = vld4q_u8(overlay + (4 * x));
+        const uint8x16_t alpha = scaleAlpha16(src.val[3], global);
+        if(step == 1) {
+            vst1q_u8(y + x, blend16(vld1q_u8(y + x), luma16(src), alpha));
+        }
+        else if(step == 2) {
+            uint8x16x2_t samples = vld2q_u8(y + (2 * x));
+            samples.val[0] = blend16(samples.val[0], luma16(src), alpha);
+            vst2q_u8(y + (2 * x), samples);
+        }
+        else {
+            break;
+        }
+    }
+#endif
+    for(; x < width; x++) {
+        const uint8_t* src = overlay + (4 * x);
+        const int alpha = div255(src[3] * globalAlpha);
+        uint8_t& sample = y[x * step];
+        sample = blendSample(sample, luma({src[0], src[1], src[2], 0xFF}), alpha);
+    }
+}
+
+void G2dCpuKernels::blendRgbaIntoChroma(const uint8_t* const* pixels, size_t count, uint8_t globalAlpha, uint8_t* u, uint8_t* v) {
+    // the block is blended with its total coverage and the coverage weighted overlay chroma
+    int coverage = 0;
+    int weightedU = 0;
+    int weightedV = 0;
+    for(size_t i = 0; i < count; i++) {
+        const uint8_t* src = pixels[i];
+        if(src == nullptr) {
+            continue;
+        }
+        const int alpha = div255(src[3] * globalAlpha);
+        coverage += alpha;
+        weightedU += alpha * chroma(src[0], src[1], src[2], CbR, CbG, CbB);
+        weightedV += alpha * chroma(src[0], src[1], src[2], CrR, CrG, CrB);
+    }
+    if(coverage == 0) {
+        return;
+    }
+
+    const int total = 255 * static_cast<int>(count);
+    *u = static_cast<uint8_t>(((*u * (total - coverage)) + weightedU + (total / 2)) / total);
+    *v = static_cast<uint8_t>(((*v * (total - coverage)) + weightedV + (total / 2)) / total);
+}
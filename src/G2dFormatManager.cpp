@@ -1,5 +1,26 @@
 #include "G2dFormatManager.hpp"
 #include <iostream>
+#include <algorithm>
+#include <limits>
+
+namespace {
+    /// @brief Multiplies two sizes, empty optional if the product does not fit in size_t
+    std::optional<size_t> checkedMultiply(size_t a, size_t b) {
+        if(a != 0 && b > std::numeric_limits<size_t>::max() / a) {
+            return {};
+        }
+        return a * b;
+    }
+
+    /// @brief Number of bits in a frame, empty optional if it does not fit in size_t
+    std::optional<size_t> frameBits(size_t width, size_t height, size_t bpp) {
+        const std::optional<size_t> pixels = checkedMultiply(width, height);
+        if(!pixels.has_value()) {
+            return {};
+        }
+        return checkedMultiply(*pixels, bpp);
+    }
+}
 
 std::optional<OrqaG2dFormat> G2dFormatManager::getFormatEnumFromString(const std::string& formatStr) {
     if(OrqaFormatLookup.find(formatStr) == OrqaFormatLookup.end()) {
@@ -9,6 +30,15 @@ std::optional<OrqaG2dFormat> G2dFormatManager::getFormatEnumFromString(const std
     
 }
 
+std::optional<std::string> G2dFormatManager::getFormatString(OrqaG2dFormat format) {
+    for(const auto& [alias, orqaFormat] : OrqaFormatLookup) {
+        if(orqaFormat == format) {
+            return alias;
+        }
+    }
+    return {};
+}
+
 std::optional<G2dFormatMetadata> G2dFormatManager::getFormatMetadata(OrqaG2dFormat format) {
     if(OrqaToG2DFormatMap.find(format) == OrqaToG2DFormatMap.end()) {
         return {};
@@ -17,6 +47,62 @@ std::optional<G2dFormatMetadata> G2dFormatManager::getFormatMetadata(OrqaG2dForm
     return OrqaToG2DFormatMap.at(format);
 }
 
+std::optional<size_t> G2dFormatManager::getFrameSize(OrqaG2dFormat format, size_t width, size_t height) {
+    std::optional<G2dFormatMetadata> metadata = getFormatMetadata(format);
+    if(!metadata.has_value()) {
+        return {};
+    }
+    const std::optional<size_t> bits = frameBits(width, height, metadata->bpp);
+    if(!bits.has_value()) {
+        return {};
+    }
+    return *bits / 8;
+}
+
+std::optional<G2dFrameLayout> G2dFormatManager::getFrameLayout(OrqaG2dFormat format, size_t width, size_t height) {
+    std::optional<G2dFormatMetadata> metadata = getFormatMetadata(format);
+    if(!metadata.has_value()) {
+        return {};
+    }
+    const std::optional<size_t> bits = frameBits(width, height, metadata->bpp);
+    if(!bits.has_value()) {
+        return {};
+    }
+
+    const size_t lumaSize = width * height;
+    G2dFrameLayout layout;
+    layout.frameSize = *bits / 8;
+
+    switch(format) {
+        case OrqaG2dFormat::FMT_NV12:
+        case OrqaG2dFormat::FMT_NV21:
+            layout.planeCount = 2;
+            layout.planes[0] = {0, width, height, 8, 1};
+            layout.planes[1] = {lumaSize, width, height / 2, 8, 2};
+            break;
+        case OrqaG2dFormat::FMT_NV16:
+        case OrqaG2dFormat::FMT_NV61:
+            layout.planeCount = 2;
+            layout.planes[0] = {0, width, height, 8, 1};
+            layout.planes[1] = {lumaSize, width, height, 8, 1};
+            break;
+        case OrqaG2dFormat::FMT_I420:
+        case OrqaG2dFormat::FMT_YV12:
+            layout.planeCount = 3;
+            layout.planes[0] = {0, width, height, 8, 1};
+            layout.planes[1] = {lumaSize, width / 2, height / 2, 4, 2};
+            layout.planes[2] = {lumaSize + (lumaSize / 4), width / 2, height / 2, 4, 2};
+            break;
+        default:
+            // packed formats, RGB and YUV 4:2:2 alike, and 8 bit gray
+            layout.planeCount = 1;
+            layout.planes[0] = {0, (width * metadata->bpp) / 8, height, metadata->bpp, 1};
+            break;
+    }
+
+    return layout;
+}
+
 FormatManagerStatus G2dFormatManager::isFormatConversionSupported(g2d_format srcFormat, g2d_format destFormat) {
     if(
         std::find(
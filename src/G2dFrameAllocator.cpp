@@ -0,0 +1,79 @@
+#include "G2dFrameAllocator.hpp"
+
+#include <atomic>
+#include <sys/mman.h>
+
+namespace {
+
+std::atomic<G2dHugePagePolicy> gHugePagePolicy {G2dHugePagePolicy::TRANSPARENT};
+
+size_t roundToHugePages(size_t bytes) {
+    return (bytes + G2dFrameMemory::HugePageSize - 1) & ~(G2dFrameMemory::HugePageSize - 1);
+}
+
+/// @brief Maps a huge page aligned block of regular pages
+void* mapAligned(size_t length) {
+    // over-map by one huge page and trim, so the block starts on a huge page boundary
+    const size_t reserved = length + G2dFrameMemory::HugePageSize;
+    void* mapping = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const auto start = reinterpret_cast<uintptr_t>(mapping);
+    const uintptr_t aligned = (start + G2dFrameMemory::HugePageSize - 1) & ~(G2dFrameMemory::HugePageSize - 1);
+    if(aligned > start) {
+        munmap(mapping, aligned - start);
+    }
+    const size_t tail = (start + reserved) - (aligned + length);
+    if(tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+}
+
+void* G2dFrameMemory::allocate(size_t bytes) {
+    if(bytes < HugePageSize) {
+        return ::operator new(bytes == 0 ? 1 : bytes, std::align_val_t {Alignment});
+    }
+
+    const size_t length = roundToHugePages(bytes);
+    const G2dHugePagePolicy policy = gHugePagePolicy.load(std::memory_order_relaxed);
+    if(policy == G2dHugePagePolicy::EXPLICIT) {
+        void* block = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(block != MAP_FAILED) {
+            return block;
+        }
+    }
+
+    void* block = mapAligned(length);
+    if(block == nullptr) {
+        throw std::bad_alloc();
+    }
+    if(policy != G2dHugePagePolicy::NONE) {
+        // only a hint, the kernel may have transparent huge pages disabled
+        madvise(block, length, MADV_HUGEPAGE);
+    }
+    return block;
+}
+
+void G2dFrameMemory::deallocate(void* block, size_t bytes) {
+    if(block == nullptr) {
+        return;
+    }
+    if(bytes < HugePageSize) {
+        ::operator delete(block, std::align_val_t {Alignment});
+        return;
+    }
+    munmap(block, roundToHugePages(bytes));
+}
+
+void G2dFrameMemory::setHugePagePolicy(G2dHugePagePolicy policy) {
+    gHugePagePolicy.store(policy, std::memory_order_relaxed);
+}
+
+G2dHugePagePolicy G2dFrameMemory::hugePagePolicy() {
+    return gHugePagePolicy.load(std::memory_order_relaxed);
+}
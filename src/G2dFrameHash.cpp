@@ -0,0 +1,94 @@
+#include "G2dFrameHash.hpp"
+
+#include <cstring>
+
+namespace {
+    constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotateLeft(uint64_t value, unsigned bits) {
+        return (value << bits) | (value >> (64U - bits));
+    }
+
+    inline uint64_t read64(const uint8_t* data) {
+        uint64_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t read32(const uint8_t* data) {
+        uint32_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t round(uint64_t accumulator, uint64_t input) {
+        accumulator += input * Prime2;
+        accumulator = rotateLeft(accumulator, 31);
+        return accumulator * Prime1;
+    }
+
+    inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+        accumulator ^= round(0, value);
+        return (accumulator * Prime1) + Prime4;
+    }
+}
+
+uint64_t G2dFrameHash::hash64(std::span<const uint8_t> data, uint64_t seed) {
+    const uint8_t* pointer = data.data();
+    const uint8_t* const end = pointer + data.size();
+    uint64_t hash = 0;
+
+    if(data.size() >= 32) {
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+
+        const uint8_t* const limit = end - 32;
+        do {
+            v1 = round(v1, read64(pointer));
+            v2 = round(v2, read64(pointer + 8));
+            v3 = round(v3, read64(pointer + 16));
+            v4 = round(v4, read64(pointer + 24));
+            pointer += 32;
+        } while(pointer <= limit);
+
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else {
+        hash = seed + Prime5;
+    }
+
+    hash += static_cast<uint64_t>(data.size());
+
+    while(pointer + 8 <= end) {
+        hash ^= round(0, read64(pointer));
+        hash = (rotateLeft(hash, 27) * Prime1) + Prime4;
+        pointer += 8;
+    }
+    if(pointer + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(pointer)) * Prime1;
+        hash = (rotateLeft(hash, 23) * Prime2) + Prime3;
+        pointer += 4;
+    }
+    while(pointer < end) {
+        hash ^= static_cast<uint64_t>(*pointer) * Prime5;
+        hash = rotateLeft(hash, 11) * Prime1;
+        pointer++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
@@ -0,0 +1,339 @@
+#include "G2dFrameRing.hpp"
+#include "G2dFrameAllocator.hpp"
+
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <utility>
+
+/// @brief Control block at the start of the ring memory, shared by both processes
+/// The producer and consumer indices sit on separate cache lines so the two sides do not
+/// invalidate each other's line on every frame.
+struct G2dFrameRingHeader {
+    uint64_t magic;
+    uint64_t slotSize;
+    uint64_t slotCount;
+    uint64_t slotStride;
+    uint64_t slotOffset;
+
+    alignas(64) std::atomic<uint64_t> writeIndex;
+    alignas(64) std::atomic<uint64_t> readIndex;
+    alignas(64) std::atomic<uint32_t> consumerWaiting;
+    std::atomic<uint32_t> producerWaiting;
+    std::atomic<uint32_t> closed;
+};
+
+namespace {
+
+constexpr uint64_t RingMagic = 0x31474e4952443247; // "G2DRING1"
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring indices must be lock-free to be shared between processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Ring flags must be lock-free to be shared between processes");
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void signalEvent(int eventFd) {
+    const uint64_t one = 1;
+    // a full counter already wakes the waiter, so a failed write needs no handling
+    [[maybe_unused]] ssize_t written = write(eventFd, &one, sizeof(one));
+}
+
+/// @brief Blocks until ready() holds, the ring is closed or the timeout expires
+/// The waiting flag tells the other side to signal the event. It is raised before ready() is checked
+/// again, and the other side checks it after publishing, so a wakeup can not be lost in between.
+template <typename Ready>
+G2dFrameRingStatus waitUntil(
+    G2dFrameRingHeader& header,
+    std::atomic<uint32_t>& waiting,
+    int eventFd,
+    int timeoutMs,
+    Ready ready
+)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    for(;;) {
+        if(ready()) {
+            return G2dFrameRingStatus::SUCCESS;
+        }
+        if(header.closed.load(std::memory_order_acquire) != 0) {
+            return G2dFrameRingStatus::CLOSED;
+        }
+
+        if(timeoutMs == 0) {
+            return G2dFrameRingStatus::TIMEOUT;
+        }
+        int remainingMs = -1;
+        if(timeoutMs > 0) {
+            remainingMs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+            if(remainingMs <= 0) {
+                return G2dFrameRingStatus::TIMEOUT;
+            }
+        }
+
+        waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(ready() || header.closed.load(std::memory_order_acquire) != 0) {
+            waiting.store(0, std::memory_order_relaxed);
+            continue;
+        }
+
+        pollfd pollFd {eventFd, POLLIN, 0};
+        const int result = poll(&pollFd, 1, remainingMs);
+        waiting.store(0, std::memory_order_relaxed);
+
+        if(result < 0 && errno != EINTR) {
+            std::cerr << "Failed to wait on the frame ring" << "\n";
+            return G2dFrameRingStatus::WAIT_ERROR;
+        }
+        if(result > 0) {
+            uint64_t count = 0;
+            [[maybe_unused]] ssize_t readBytes = read(eventFd, &count, sizeof(count));
+        }
+    }
+}
+
+} // namespace
+
+G2dFrameRing::~G2dFrameRing() {
+    release();
+}
+
+G2dFrameRing::G2dFrameRing(G2dFrameRing&& other) noexcept
+    : mMemory(std::move(other.mMemory)),
+      mHeader(std::exchange(other.mHeader, nullptr)),
+      mSlots(std::exchange(other.mSlots, {})),
+      mDataEventFd(std::exchange(other.mDataEventFd, -1)),
+      mSpaceEventFd(std::exchange(other.mSpaceEventFd, -1)),
+      mWriteIndex(other.mWriteIndex),
+      mReadIndex(other.mReadIndex),
+      mCachedReadIndex(other.mCachedReadIndex),
+      mCachedWriteIndex(other.mCachedWriteIndex) {}
+
+G2dFrameRing& G2dFrameRing::operator=(G2dFrameRing&& other) noexcept {
+    if(this != &other) {
+        release();
+        mMemory = std::move(other.mMemory);
+        mHeader = std::exchange(other.mHeader, nullptr);
+        mSlots = std::exchange(other.mSlots, {});
+        mDataEventFd = std::exchange(other.mDataEventFd, -1);
+        mSpaceEventFd = std::exchange(other.mSpaceEventFd, -1);
+        mWriteIndex = other.mWriteIndex;
+        mReadIndex = other.mReadIndex;
+        mCachedReadIndex = other.mCachedReadIndex;
+        mCachedWriteIndex = other.mCachedWriteIndex;
+    }
+    return *this;
+}
+
+G2dFrameRingStatus G2dFrameRing::create(size_t slotSize, size_t slotCount) {
+    release();
+
+    if(slotSize == 0 || slotCount == 0) {
+        std::cerr << "Frame ring needs at least one slot of non-zero size" << "\n";
+        return G2dFrameRingStatus::ALLOCATION_ERROR;
+    }
+
+    // slots start on a page boundary and stay aligned to a cache line
+    SlotGeometry slots;
+    slots.size = slotSize;
+    slots.count = slotCount;
+    slots.stride = roundUp(slotSize, G2dFrameMemory::Alignment);
+    slots.offset = roundUp(sizeof(G2dFrameRingHeader), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+
+    G2dSharedFrame memory;
+    if(memory.allocate(slots.offset + slots.stride * slots.count) != G2dSharedFrameStatus::SUCCESS) {
+        return G2dFrameRingStatus::ALLOCATION_ERROR;
+    }
+
+    G2dFrameRingHeader* header = new (memory.data()) G2dFrameRingHeader {};
+    header->magic = RingMagic;
+    header->slotSize = slots.size;
+    header->slotCount = slots.count;
+    header->slotStride = slots.stride;
+    header->slotOffset = slots.offset;
+
+    const int dataEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    const int spaceEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(dataEventFd < 0 || spaceEventFd < 0) {
+        std::cerr << "Failed to create frame ring events" << "\n";
+        if(dataEventFd >= 0) {
+            ::close(dataEventFd);
+        }
+        if(spaceEventFd >= 0) {
+            ::close(spaceEventFd);
+        }
+        return G2dFrameRingStatus::ALLOCATION_ERROR;
+    }
+
+    return map(std::move(memory), slots, dataEventFd, spaceEventFd);
+}
+
+G2dFrameRingStatus G2dFrameRing::attach(int memoryFd, int dataEventFd, int spaceEventFd) {
+    release();
+
+    struct stat fileStat {};
+    if(fstat(memoryFd, &fileStat) < 0 || static_cast<size_t>(fileStat.st_size) < sizeof(G2dFrameRingHeader)) {
+        std::cerr << "Shared memory is too small for a frame ring" << "\n";
+        ::close(memoryFd);
+        ::close(dataEventFd);
+        ::close(spaceEventFd);
+        return G2dFrameRingStatus::MAPPING_ERROR;
+    }
+
+    // the shared frame closes the memory descriptor itself if mapping fails
+    G2dSharedFrame memory;
+    if(memory.attach(memoryFd, static_cast<size_t>(fileStat.st_size), true) != G2dSharedFrameStatus::SUCCESS) {
+        ::close(dataEventFd);
+        ::close(spaceEventFd);
+        return G2dFrameRingStatus::MAPPING_ERROR;
+    }
+
+    // the layout is read from the shared header exactly once, and only the checked copy is used.
+    // Volatile reads keep the compiler from loading a field again after it was checked
+    const volatile G2dFrameRingHeader* header = reinterpret_cast<const volatile G2dFrameRingHeader*>(memory.data());
+    SlotGeometry slots;
+    slots.size = static_cast<size_t>(header->slotSize);
+    slots.count = static_cast<size_t>(header->slotCount);
+    slots.stride = static_cast<size_t>(header->slotStride);
+    slots.offset = static_cast<size_t>(header->slotOffset);
+
+    // offset + stride * count <= size, written so that hostile values cannot wrap around
+    if(
+        header->magic != RingMagic ||
+        slots.size == 0 ||
+        slots.count == 0 ||
+        slots.stride < slots.size ||
+        slots.offset < sizeof(G2dFrameRingHeader) ||
+        slots.offset > memory.size() ||
+        slots.stride > (memory.size() - slots.offset) / slots.count
+    ) {
+        std::cerr << "Shared memory does not hold a frame ring" << "\n";
+        ::close(dataEventFd);
+        ::close(spaceEventFd);
+        return G2dFrameRingStatus::MAPPING_ERROR;
+    }
+
+    return map(std::move(memory), slots, dataEventFd, spaceEventFd);
+}
+
+G2dFrameRingStatus G2dFrameRing::map(G2dSharedFrame&& memory, const SlotGeometry& slots, int dataEventFd, int spaceEventFd) {
+    mMemory = std::move(memory);
+    mHeader = reinterpret_cast<G2dFrameRingHeader*>(mMemory.data());
+    mSlots = slots;
+    mDataEventFd = dataEventFd;
+    mSpaceEventFd = spaceEventFd;
+
+    mWriteIndex = mHeader->writeIndex.load(std::memory_order_acquire);
+    mReadIndex = mHeader->readIndex.load(std::memory_order_acquire);
+    mCachedReadIndex = mReadIndex;
+    mCachedWriteIndex = mWriteIndex;
+    return G2dFrameRingStatus::SUCCESS;
+}
+
+void G2dFrameRing::release() {
+    mMemory.release();
+    mHeader = nullptr;
+    mSlots = {};
+    if(mDataEventFd >= 0) {
+        ::close(mDataEventFd);
+        mDataEventFd = -1;
+    }
+    if(mSpaceEventFd >= 0) {
+        ::close(mSpaceEventFd);
+        mSpaceEventFd = -1;
+    }
+    mWriteIndex = 0;
+    mReadIndex = 0;
+    mCachedReadIndex = 0;
+    mCachedWriteIndex = 0;
+}
+
+std::array<int, 3> G2dFrameRing::fds() const {
+    return {mMemory.fd(), mDataEventFd, mSpaceEventFd};
+}
+
+size_t G2dFrameRing::slotSize() const {
+    return mSlots.size;
+}
+
+size_t G2dFrameRing::slotCount() const {
+    return mSlots.count;
+}
+
+uint8_t* G2dFrameRing::slotData(uint64_t index) {
+    return mMemory.data() + mSlots.offset + (index % mSlots.count) * mSlots.stride;
+}
+
+G2dFrameRingStatus G2dFrameRing::acquireWrite(std::span<uint8_t>& slot, int timeoutMs) {
+    if(mHeader->closed.load(std::memory_order_relaxed) != 0) {
+        return G2dFrameRingStatus::CLOSED;
+    }
+
+    // the consumer index is only read again once the cached copy says the ring is full
+    if(mWriteIndex - mCachedReadIndex >= mSlots.count) {
+        auto hasSpace = [this]() {
+            mCachedReadIndex = mHeader->readIndex.load(std::memory_order_acquire);
+            return mWriteIndex - mCachedReadIndex < mSlots.count;
+        };
+        const G2dFrameRingStatus status = waitUntil(*mHeader, mHeader->producerWaiting, mSpaceEventFd, timeoutMs, hasSpace);
+        if(status != G2dFrameRingStatus::SUCCESS) {
+            return status;
+        }
+    }
+
+    slot = {slotData(mWriteIndex), mSlots.size};
+    return G2dFrameRingStatus::SUCCESS;
+}
+
+void G2dFrameRing::commitWrite() {
+    mWriteIndex++;
+    mHeader->writeIndex.store(mWriteIndex, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(mHeader->consumerWaiting.load(std::memory_order_relaxed) != 0) {
+        signalEvent(mDataEventFd);
+    }
+}
+
+G2dFrameRingStatus G2dFrameRing::acquireRead(std::span<uint8_t>& slot, int timeoutMs) {
+    if(mReadIndex == mCachedWriteIndex) {
+        auto hasFrame = [this]() {
+            mCachedWriteIndex = mHeader->writeIndex.load(std::memory_order_acquire);
+            return mReadIndex != mCachedWriteIndex;
+        };
+        const G2dFrameRingStatus status = waitUntil(*mHeader, mHeader->consumerWaiting, mDataEventFd, timeoutMs, hasFrame);
+        // the producer may have published its last frame right before closing, after the index was loaded.
+        // The acquire on closed makes that frame visible, so it is checked for once more
+        if(status != G2dFrameRingStatus::SUCCESS && !(status == G2dFrameRingStatus::CLOSED && hasFrame())) {
+            return status;
+        }
+    }
+
+    slot = {slotData(mReadIndex), mSlots.size};
+    return G2dFrameRingStatus::SUCCESS;
+}
+
+void G2dFrameRing::releaseRead() {
+    mReadIndex++;
+    mHeader->readIndex.store(mReadIndex, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(mHeader->producerWaiting.load(std::memory_order_relaxed) != 0) {
+        signalEvent(mSpaceEventFd);
+    }
+}
+
+void G2dFrameRing::close() {
+    mHeader->closed.store(1, std::memory_order_seq_cst);
+    signalEvent(mDataEventFd);
+    signalEvent(mSpaceEventFd);
+}
@@ -0,0 +1,81 @@
+#include "G2dFrameRingConverter.hpp"
+#include "G2dFormatManager.hpp"
+
+#include <iostream>
+
+namespace {
+
+G2dFrameRingConverterStatus fromRingStatus(G2dFrameRingStatus status) {
+    switch(status) {
+        case G2dFrameRingStatus::SUCCESS:
+            return G2dFrameRingConverterStatus::SUCCESS;
+        case G2dFrameRingStatus::TIMEOUT:
+            return G2dFrameRingConverterStatus::TIMEOUT;
+        case G2dFrameRingStatus::CLOSED:
+            return G2dFrameRingConverterStatus::CLOSED;
+        default:
+            return G2dFrameRingConverterStatus::RING_ERROR;
+    }
+}
+
+} // namespace
+
+G2dFrameRingConverter::G2dFrameRingConverter(OrqaG2dFormat srcFormat, OrqaG2dFormat destFormat, size_t width, size_t height)
+    : mSrcFormat(srcFormat),
+      mDestFormat(destFormat),
+      mWidth(width),
+      mHeight(height),
+      mSrcFrameSize(G2dFormatManager::getFrameSize(srcFormat, width, height).value_or(0)),
+      mDestFrameSize(G2dFormatManager::getFrameSize(destFormat, width, height).value_or(0)) {}
+
+G2dPixelFormatConverter& G2dFrameRingConverter::converter() {
+    return mConverter;
+}
+
+G2dFrameRingConverterStatus G2dFrameRingConverter::convertNext(G2dFrameRing& input, G2dFrameRing& output, int timeoutMs) {
+    if(mSrcFrameSize == 0 || mDestFrameSize == 0 || input.slotSize() < mSrcFrameSize || output.slotSize() < mDestFrameSize) {
+        std::cerr << "Frame ring slots are too small for the converted frames" << "\n";
+        return G2dFrameRingConverterStatus::SLOT_SIZE_ERROR;
+    }
+
+    std::span<uint8_t> srcSlot;
+    G2dFrameRingStatus ringStatus = input.acquireRead(srcSlot, timeoutMs);
+    if(ringStatus != G2dFrameRingStatus::SUCCESS) {
+        return fromRingStatus(ringStatus);
+    }
+
+    std::span<uint8_t> destSlot;
+    ringStatus = output.acquireWrite(destSlot, timeoutMs);
+    if(ringStatus != G2dFrameRingStatus::SUCCESS) {
+        return fromRingStatus(ringStatus);
+    }
+
+    const G2dPixelFormatConverterStatus result = mConverter.convertImage(
+        mSrcFormat,
+        mDestFormat,
+        std::span<const uint8_t>(srcSlot.first(mSrcFrameSize)),
+        destSlot.first(mDestFrameSize),
+        mWidth,
+        mHeight,
+        mWidth,
+        mHeight
+    );
+
+    if(result == G2dPixelFormatConverterStatus::SUCCESS) {
+        output.commitWrite();
+    }
+    input.releaseRead();
+    return result == G2dPixelFormatConverterStatus::SUCCESS
+        ? G2dFrameRingConverterStatus::SUCCESS
+        : G2dFrameRingConverterStatus::CONVERSION_ERROR;
+}
+
+G2dFrameRingConverterStatus G2dFrameRingConverter::run(G2dFrameRing& input, G2dFrameRing& output) {
+    G2dFrameRingConverterStatus status = G2dFrameRingConverterStatus::SUCCESS;
+    while(status == G2dFrameRingConverterStatus::SUCCESS || status == G2dFrameRingConverterStatus::CONVERSION_ERROR) {
+        status = convertNext(input, output);
+    }
+
+    output.close();
+    return status == G2dFrameRingConverterStatus::CLOSED ? G2dFrameRingConverterStatus::SUCCESS : status;
+}
@@ -0,0 +1,243 @@
+#include "G2dFrameScheduler.hpp"
+
+#include <algorithm>
+
+namespace {
+
+/// @brief Weight of the newest sample in the moving average of conversion times, as a power of two
+constexpr int ConversionTimeSmoothingShift = 3;
+
+}
+
+G2dFrameScheduler::G2dFrameScheduler(size_t workerCount) {
+    const size_t count = workerCount == 0 ? 1 : workerCount;
+    mWorkers.reserve(count);
+    for(size_t i = 0; i < count; i++) {
+        mWorkers.emplace_back(&G2dFrameScheduler::runWorker, this);
+    }
+}
+
+G2dFrameScheduler::~G2dFrameScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for(std::thread& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+size_t G2dFrameScheduler::addStream(const G2dStreamOptions& options) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    Stream& stream = mStreams.emplace_back();
+    stream.options = options;
+    stream.options.queueDepth = std::max<size_t>(1, options.queueDepth);
+    return mStreams.size() - 1;
+}
+
+G2dFrameSchedulerStatus G2dFrameScheduler::submit(
+    size_t stream,
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const std::vector<uint8_t>& srcBuffer,
+    std::vector<uint8_t>& destBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    std::chrono::steady_clock::time_point deadline,
+    CompletionCallback callback
+)
+{
+    Frame frame;
+    frame.srcFormat = srcFormat;
+    frame.destFormat = destFormat;
+    frame.srcBuffer = &srcBuffer;
+    frame.destBuffer = &destBuffer;
+    frame.srcWidth = srcWidth;
+    frame.srcHeight = srcHeight;
+    frame.destWidth = destWidth;
+    frame.destHeight = destHeight;
+    frame.submitted = std::chrono::steady_clock::now();
+    frame.deadline = deadline;
+    frame.callback = std::move(callback);
+
+    std::vector<DroppedFrame> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(stream >= mStreams.size()) {
+            return G2dFrameSchedulerStatus::INVALID_STREAM_ERROR;
+        }
+
+        Stream& target = mStreams[stream];
+        target.stats.submitted++;
+
+        // a frame that is already too late must not push a frame that can still make it out of the queue
+        if(isStale(target, frame, frame.submitted)) {
+            target.stats.droppedStale++;
+            dropped.push_back({std::move(frame), G2dFrameOutcome::DROPPED_STALE});
+        }
+        else {
+            if(target.queue.size() >= target.options.queueDepth) {
+                target.stats.droppedOverflow++;
+                if(target.options.overflowPolicy == G2dOverflowPolicy::DROP_NEWEST) {
+                    return G2dFrameSchedulerStatus::QUEUE_FULL_ERROR;
+                }
+                dropped.push_back({std::move(target.queue.front()), G2dFrameOutcome::DROPPED_OVERFLOW});
+                target.queue.pop_front();
+                mQueuedFrames--;
+            }
+
+            target.queue.push_back(std::move(frame));
+            mQueuedFrames++;
+            target.stats.queueDepth = target.queue.size();
+            target.stats.peakQueueDepth = std::max(target.stats.peakQueueDepth, target.stats.queueDepth);
+        }
+    }
+
+    mWake.notify_one();
+    reportDropped(dropped);
+    return G2dFrameSchedulerStatus::SUCCESS;
+}
+
+std::optional<G2dStreamStats> G2dFrameScheduler::stats(size_t stream) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(stream >= mStreams.size()) {
+        return {};
+    }
+    return mStreams[stream].stats;
+}
+
+size_t G2dFrameScheduler::workerCount() const {
+    return mWorkers.size();
+}
+
+bool G2dFrameScheduler::isStale(const Stream& stream, const Frame& frame, std::chrono::steady_clock::time_point now) {
+    return now + stream.conversionTime > frame.deadline;
+}
+
+std::optional<G2dFrameScheduler::Frame> G2dFrameScheduler::takeNextFrame(std::vector<DroppedFrame>& dropped, size_t& stream) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    // queues are short, so every frame is checked rather than only the head of each queue
+    std::optional<size_t> best;
+    for(size_t i = 0; i < mStreams.size(); i++) {
+        Stream& candidate = mStreams[i];
+        for(auto it = candidate.queue.begin(); it != candidate.queue.end();) {
+            if(isStale(candidate, *it, now)) {
+                candidate.stats.droppedStale++;
+                dropped.push_back({std::move(*it), G2dFrameOutcome::DROPPED_STALE});
+                it = candidate.queue.erase(it);
+                mQueuedFrames--;
+            }
+            else {
+                ++it;
+            }
+        }
+        candidate.stats.queueDepth = candidate.queue.size();
+        if(candidate.queue.empty()) {
+            continue;
+        }
+
+        if(
+            !best.has_value() ||
+            candidate.options.priority > mStreams[*best].options.priority ||
+            (
+                candidate.options.priority == mStreams[*best].options.priority &&
+                candidate.queue.front().deadline < mStreams[*best].queue.front().deadline
+            )
+        ) {
+            best = i;
+        }
+    }
+
+    if(!best.has_value()) {
+        return {};
+    }
+
+    Stream& chosen = mStreams[*best];
+    Frame frame = std::move(chosen.queue.front());
+    chosen.queue.pop_front();
+    chosen.stats.queueDepth = chosen.queue.size();
+    mQueuedFrames--;
+    stream = *best;
+    return frame;
+}
+
+void G2dFrameScheduler::reportDropped(std::vector<DroppedFrame>& dropped) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for(DroppedFrame& entry : dropped) {
+        if(entry.frame.callback) {
+            entry.frame.callback({entry.outcome, G2dPixelFormatConverterStatus::SUCCESS, now - entry.frame.submitted});
+        }
+    }
+    dropped.clear();
+}
+
+void G2dFrameScheduler::runWorker() {
+    G2dPixelFormatConverter converter;
+    converter.openSession();
+
+    std::vector<DroppedFrame> dropped;
+    while(true) {
+        std::optional<Frame> frame;
+        size_t stream = 0;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStopping || mQueuedFrames != 0; });
+            if(mQueuedFrames == 0) {
+                break;
+            }
+            frame = takeNextFrame(dropped, stream);
+        }
+
+        reportDropped(dropped);
+        if(!frame.has_value()) {
+            continue;
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const G2dPixelFormatConverterStatus status = converter.convertImage(
+            frame->srcFormat,
+            frame->destFormat,
+            *frame->srcBuffer,
+            *frame->destBuffer,
+            frame->srcWidth,
+            frame->srcHeight,
+            frame->destWidth,
+            frame->destHeight
+        );
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        G2dFrameOutcome outcome = G2dFrameOutcome::FAILED;
+        if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+            outcome = end > frame->deadline ? G2dFrameOutcome::CONVERTED_LATE : G2dFrameOutcome::CONVERTED;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            Stream& owner = mStreams[stream];
+            if(outcome == G2dFrameOutcome::FAILED) {
+                owner.stats.failed++;
+            }
+            else {
+                owner.stats.converted++;
+                owner.stats.late += outcome == G2dFrameOutcome::CONVERTED_LATE ? 1 : 0;
+                // the first sample seeds the average, smoothing from zero would underestimate it for a dozen frames
+                if(owner.stats.converted == 1) {
+                    owner.conversionTime = end - start;
+                }
+                else {
+                    owner.conversionTime += ((end - start) - owner.conversionTime) / (1 << ConversionTimeSmoothingShift);
+                }
+            }
+        }
+
+        if(frame->callback) {
+            frame->callback({outcome, status, end - frame->submitted});
+        }
+    }
+
+    converter.closeSession();
+}
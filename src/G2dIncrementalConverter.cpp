@@ -0,0 +1,283 @@
+#include "G2dIncrementalConverter.hpp"
+#include "G2dCpuKernels.hpp"
+#include "G2dFormatManager.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+G2dIncrementalConverter::G2dIncrementalConverter(size_t tileWidth, size_t tileHeight)
+    : mTileWidth(std::max<size_t>(2, (tileWidth + 1) & ~static_cast<size_t>(1))),
+      mTileHeight(std::max<size_t>(2, (tileHeight + 1) & ~static_cast<size_t>(1))) {}
+
+G2dIncrementalConverter::~G2dIncrementalConverter() {
+    releaseBuffers();
+    if(!mBufferPool.clear()) {
+        std::cerr << "Failed to free buffers" << "\n";
+    }
+    if(mHandle != nullptr && g2d_close(mHandle) < 0) {
+        std::cerr << "Failed to close the video accelerator" << "\n";
+    }
+}
+
+G2dPixelFormatConverterStatus G2dIncrementalConverter::convertFrame(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    std::span<const uint8_t> srcBuffer,
+    size_t width,
+    size_t height
+)
+{
+    std::optional<G2dFormatMetadata> srcG2dFormat = G2dFormatManager::getFormatMetadata(srcFormat);
+    std::optional<G2dFormatMetadata> destG2dFormat = G2dFormatManager::getFormatMetadata(destFormat);
+    if(!srcG2dFormat.has_value() || !destG2dFormat.has_value()) {
+        std::cerr << "Invalid source or destination format" << "\n";
+        return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+    }
+
+    if(
+        !srcG2dFormat->deviceSupported || !destG2dFormat->deviceSupported ||
+        G2dFormatManager::isFormatConversionSupported(srcG2dFormat->format, destG2dFormat->format)
+            != FormatManagerStatus::SUCCESS
+    ) {
+        std::cerr << "Image conversion failed due to unsupported format pair." << "\n";
+        return G2dPixelFormatConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+    }
+
+    const std::optional<G2dFrameLayout> srcLayout = G2dFormatManager::getFrameLayout(srcFormat, width, height);
+    const std::optional<G2dFrameLayout> destLayout = G2dFormatManager::getFrameLayout(destFormat, width, height);
+    if(!srcLayout.has_value() || !destLayout.has_value() || srcBuffer.size() < srcLayout->frameSize) {
+        std::cerr << "Source buffer is too small for the given image size" << "\n";
+        return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+    }
+
+    // odd sizes cannot be split into tiles that keep chroma samples whole
+    const bool canTile = width % 2 == 0 && height % 2 == 0;
+    if(
+        !mHasFrame || !canTile ||
+        srcFormat != mSrcFormat || destFormat != mDestFormat ||
+        width != mWidth || height != mHeight
+    ) {
+        mSrcFormat = srcFormat;
+        mDestFormat = destFormat;
+        mWidth = width;
+        mHeight = height;
+        mSrcLayout = *srcLayout;
+        mDestLayout = *destLayout;
+        return convertFull(srcBuffer);
+    }
+
+    return convertDirtyTiles(srcBuffer);
+}
+
+std::span<const uint8_t> G2dIncrementalConverter::output() const {
+    return mOutput;
+}
+
+size_t G2dIncrementalConverter::lastDirtyTileCount() const {
+    return mLastDirtyTiles;
+}
+
+size_t G2dIncrementalConverter::tileCount() const {
+    return ((mWidth + mTileWidth - 1) / mTileWidth) * ((mHeight + mTileHeight - 1) / mTileHeight);
+}
+
+void G2dIncrementalConverter::reset() {
+    mHasFrame = false;
+    releaseBuffers();
+}
+
+G2dPixelFormatConverterStatus G2dIncrementalConverter::convertFull(std::span<const uint8_t> srcBuffer) {
+    mHasFrame = false;
+    releaseBuffers();
+
+    if(openDevice() != G2dPixelFormatConverterStatus::SUCCESS) {
+        return G2dPixelFormatConverterStatus::DEVICE_ERROR;
+    }
+
+    mSrcG2dBuf = mBufferPool.acquire(mSrcLayout.frameSize);
+    mDestG2dBuf = mBufferPool.acquire(mDestLayout.frameSize);
+    if(mSrcG2dBuf == nullptr || mDestG2dBuf == nullptr) {
+        releaseBuffers();
+        return G2dPixelFormatConverterStatus::MEMORY_ALLOCATION_ERROR;
+    }
+
+    const g2d_format srcG2dFormat = G2dFormatManager::getFormatMetadata(mSrcFormat)->format;
+    const g2d_format destG2dFormat = G2dFormatManager::getFormatMetadata(mDestFormat)->format;
+    if(
+        G2dPixelFormatConverter::setSourceFormatSurface(
+            srcG2dFormat,
+            mSrcSurface,
+            mSrcG2dBuf,
+            static_cast<int>(mWidth),
+            static_cast<int>(mHeight)
+        ) != G2dPixelFormatConverterStatus::SUCCESS ||
+        G2dPixelFormatConverter::setDestinationFormatSurface(
+            destG2dFormat,
+            mDestSurface,
+            mDestG2dBuf,
+            static_cast<int>(mWidth),
+            static_cast<int>(mHeight)
+        ) != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        std::cerr << "Failed to set the source or destination surface" << "\n";
+        releaseBuffers();
+        return G2dPixelFormatConverterStatus::SURFACE_ERROR;
+    }
+
+    std::memcpy(mSrcG2dBuf->buf_vaddr, srcBuffer.data(), mSrcLayout.frameSize);
+
+    if(g2d_blit(mHandle, &mSrcSurface, &mDestSurface) < 0) {
+        std::cerr << "This type of conversion is currently not supported" << "\n";
+        releaseBuffers();
+        return G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+    }
+    if(g2d_finish(mHandle) < 0) {
+        std::cerr << "Failed to finish the g2d operation" << "\n";
+        releaseBuffers();
+        return G2dPixelFormatConverterStatus::FINISH_OPERATION_ERROR;
+    }
+    g2d_flush(mHandle);
+
+    mOutput.resize(mDestLayout.frameSize);
+    std::memcpy(mOutput.data(), mDestG2dBuf->buf_vaddr, mDestLayout.frameSize);
+    mPreviousSource.assign(srcBuffer.begin(), srcBuffer.begin() + static_cast<std::ptrdiff_t>(mSrcLayout.frameSize));
+
+    mLastDirtyTiles = tileCount();
+    mHasFrame = true;
+    return G2dPixelFormatConverterStatus::SUCCESS;
+}
+
+G2dPixelFormatConverterStatus G2dIncrementalConverter::convertDirtyTiles(std::span<const uint8_t> srcBuffer) {
+    // collect the changed tiles, merging horizontal neighbours into a single blit
+    std::vector<Rect> dirtyRuns;
+    mLastDirtyTiles = 0;
+    for(size_t y0 = 0; y0 < mHeight; y0 += mTileHeight) {
+        const size_t y1 = std::min(y0 + mTileHeight, mHeight);
+        bool extendRun = false;
+        for(size_t x0 = 0; x0 < mWidth; x0 += mTileWidth) {
+            const Rect tile {x0, y0, std::min(x0 + mTileWidth, mWidth), y1};
+            if(!regionChanged(mSrcLayout, srcBuffer.data(), mPreviousSource.data(), tile)) {
+                extendRun = false;
+                continue;
+            }
+
+            mLastDirtyTiles++;
+            if(extendRun) {
+                dirtyRuns.back().x1 = tile.x1;
+            }
+            else {
+                dirtyRuns.push_back(tile);
+            }
+            extendRun = true;
+        }
+    }
+
+    if(dirtyRuns.empty()) {
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    }
+
+    auto* srcPixels = static_cast<uint8_t*>(mSrcG2dBuf->buf_vaddr);
+    for(const Rect& run : dirtyRuns) {
+        copyRegion(mSrcLayout, srcBuffer.data(), mPreviousSource.data(), run);
+        copyRegion(mSrcLayout, srcBuffer.data(), srcPixels, run);
+
+        g2d_surface srcSurface = clipSurface(mSrcSurface, run, mWidth, mHeight);
+        g2d_surface destSurface = clipSurface(mDestSurface, run, mWidth, mHeight);
+        if(g2d_blit(mHandle, &srcSurface, &destSurface) < 0) {
+            std::cerr << "This type of conversion is currently not supported" << "\n";
+            reset();
+            return G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+        }
+    }
+
+    if(g2d_finish(mHandle) < 0) {
+        std::cerr << "Failed to finish the g2d operation" << "\n";
+        reset();
+        return G2dPixelFormatConverterStatus::FINISH_OPERATION_ERROR;
+    }
+    g2d_flush(mHandle);
+
+    const auto* destPixels = static_cast<const uint8_t*>(mDestG2dBuf->buf_vaddr);
+    for(const Rect& run : dirtyRuns) {
+        copyRegion(mDestLayout, destPixels, mOutput.data(), run);
+    }
+
+    return G2dPixelFormatConverterStatus::SUCCESS;
+}
+
+G2dPixelFormatConverterStatus G2dIncrementalConverter::openDevice() {
+    if(mHandle != nullptr) {
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    }
+    if(g2d_open(&mHandle) < 0) {
+        std::cerr << "Failed to open the video accelerator" << "\n";
+        mHandle = nullptr;
+        return G2dPixelFormatConverterStatus::DEVICE_ERROR;
+    }
+    return G2dPixelFormatConverterStatus::SUCCESS;
+}
+
+void G2dIncrementalConverter::releaseBuffers() {
+    mBufferPool.release(mSrcG2dBuf);
+    mBufferPool.release(mDestG2dBuf);
+    mSrcG2dBuf = nullptr;
+    mDestG2dBuf = nullptr;
+}
+
+bool G2dIncrementalConverter::regionChanged(
+    const G2dFrameLayout& layout,
+    const uint8_t* current,
+    const uint8_t* previous,
+    const Rect& rect
+)
+{
+    for(size_t i = 0; i < layout.planeCount; i++) {
+        const G2dPlaneLayout& plane = layout.planes[i];
+        const size_t firstRow = rect.y0 / plane.verticalSubsampling;
+        const size_t lastRow = (rect.y1 + plane.verticalSubsampling - 1) / plane.verticalSubsampling;
+        const size_t firstByte = (rect.x0 * plane.bpp) / 8;
+        const size_t lastByte = (rect.x1 * plane.bpp) / 8;
+        const size_t start = plane.offset + (firstRow * plane.stride) + firstByte;
+
+        if(!G2dCpuKernels::regionsEqual(current + start, previous + start, plane.stride, lastByte - firstByte, lastRow - firstRow)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void G2dIncrementalConverter::copyRegion(
+    const G2dFrameLayout& layout,
+    const uint8_t* from,
+    uint8_t* to,
+    const Rect& rect
+)
+{
+    for(size_t i = 0; i < layout.planeCount; i++) {
+        const G2dPlaneLayout& plane = layout.planes[i];
+        const size_t firstRow = rect.y0 / plane.verticalSubsampling;
+        const size_t lastRow = (rect.y1 + plane.verticalSubsampling - 1) / plane.verticalSubsampling;
+        const size_t firstByte = (rect.x0 * plane.bpp) / 8;
+        const size_t lastByte = (rect.x1 * plane.bpp) / 8;
+
+        for(size_t row = firstRow; row < lastRow; row++) {
+            const size_t start = plane.offset + (row * plane.stride) + firstByte;
+            std::memcpy(to + start, from + start, lastByte - firstByte);
+        }
+    }
+}
+
+g2d_surface G2dIncrementalConverter::clipSurface(const g2d_surface& surface, const Rect& rect, size_t width, size_t height) {
+    // map the image rectangle onto the surface coordinates, which are not always
+    // the image coordinates (packed YUV surfaces fold two image rows into one)
+    g2d_surface clipped = surface;
+    const auto surfaceWidth = static_cast<size_t>(surface.right - surface.left);
+    const auto surfaceHeight = static_cast<size_t>(surface.bottom - surface.top);
+    clipped.left = surface.left + static_cast<int>((rect.x0 * surfaceWidth) / width);
+    clipped.right = surface.left + static_cast<int>((rect.x1 * surfaceWidth) / width);
+    clipped.top = surface.top + static_cast<int>((rect.y0 * surfaceHeight) / height);
+    clipped.bottom = surface.top + static_cast<int>((rect.y1 * surfaceHeight) / height);
+    return clipped;
+}
@@ -0,0 +1,74 @@
+#include "G2dLumaPyramid.hpp"
+#include "G2dCpuKernels.hpp"
+#include "G2dFormatManager.hpp"
+
+#include <iostream>
+#include <optional>
+
+G2dLumaPyramidStatus G2dLumaPyramid::build(
+    OrqaG2dFormat srcFormat,
+    std::span<const uint8_t> srcBuffer,
+    size_t width,
+    size_t height,
+    size_t levelCount,
+    const G2dCpuConversionOptions& options
+)
+{
+    mLevels.clear();
+
+    std::optional<G2dFrameLayout> srcLayout = G2dFormatManager::getFrameLayout(srcFormat, width, height);
+    const bool lumaPlane = srcLayout.has_value() && (srcLayout->planeCount > 1 || srcFormat == OrqaG2dFormat::FMT_GRAY8);
+    if(width == 0 || height == 0 || (!lumaPlane && !G2dCpuConverter::isConversionSupported(srcFormat, OrqaG2dFormat::FMT_GRAY8, width, height))) {
+        std::cerr << "Unsupported luma pyramid source format" << "\n";
+        return G2dLumaPyramidStatus::UNSUPPORTED_FORMAT_ERROR;
+    }
+    if(srcBuffer.size() < srcLayout->frameSize) {
+        std::cerr << "Source buffer is too small for the given image size" << "\n";
+        return G2dLumaPyramidStatus::BUFFER_SIZE_ERROR;
+    }
+
+    // all levels not pointing into the source share one allocation
+    size_t storageSize = lumaPlane ? 0 : width * height;
+    size_t levelWidth = width;
+    size_t levelHeight = height;
+    size_t builtLevels = 1;
+    for(; builtLevels < levelCount && levelWidth >= 2 && levelHeight >= 2; builtLevels++) {
+        levelWidth /= 2;
+        levelHeight /= 2;
+        storageSize += levelWidth * levelHeight;
+    }
+    mStorage.resize(storageSize);
+
+    uint8_t* next = mStorage.data();
+    if(lumaPlane) {
+        mLevels.push_back({srcBuffer.subspan(srcLayout->planes[0].offset, width * height), width, height});
+    }
+    else {
+        const std::span<uint8_t> luma(next, width * height);
+        G2dCpuConverter::convertImage(srcFormat, OrqaG2dFormat::FMT_GRAY8, srcBuffer, luma, width, height, options);
+        mLevels.push_back({luma, width, height});
+        next += luma.size();
+    }
+
+    while(mLevels.size() < builtLevels) {
+        const G2dLumaPyramidLevel& parent = mLevels.back();
+        const size_t childWidth = parent.width / 2;
+        const size_t childHeight = parent.height / 2;
+        for(size_t row = 0; row < childHeight; row++) {
+            const uint8_t* top = parent.pixels.data() + (2 * row * parent.width);
+            G2dCpuKernels::downsampleRows2x2(top, top + parent.width, next + (row * childWidth), childWidth);
+        }
+        mLevels.push_back({std::span<const uint8_t>(next, childWidth * childHeight), childWidth, childHeight});
+        next += childWidth * childHeight;
+    }
+
+    return G2dLumaPyramidStatus::SUCCESS;
+}
+
+size_t G2dLumaPyramid::levelCount() const {
+    return mLevels.size();
+}
+
+const G2dLumaPyramidLevel& G2dLumaPyramid::level(size_t index) const {
+    return mLevels[index];
+}
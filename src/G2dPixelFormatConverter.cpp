@@ -1,10 +1,131 @@
 #include "G2dPixelFormatConverter.hpp"
 #include "G2dFormatManager.hpp"
+#include "G2dCpuConverter.hpp"
+#include "G2dTuningTable.hpp"
 #include "g2dEnums.hpp"
 
 #include <cstring>
 #include <iostream>
 #include <algorithm>
+#include <vector>
+
+namespace {
+
+bool isYuvFormat(g2d_format format) {
+    switch(format) {
+        case G2D_NV12:
+        case G2D_NV21:
+        case G2D_I420:
+        case G2D_YV12:
+        case G2D_NV16:
+        case G2D_NV61:
+        case G2D_YUYV:
+        case G2D_YVYU:
+        case G2D_UYVY:
+        case G2D_VYUY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool overlaysFit(std::span<const G2dOverlayLayer> overlays) {
+    return std::all_of(overlays.begin(), overlays.end(), [](const G2dOverlayLayer& layer) {
+        return layer.pixels.size() >= layer.width * layer.height * 4;
+    });
+}
+
+}
+
+G2dPixelFormatConverter::~G2dPixelFormatConverter() {
+    closeSession();
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::openSession() {
+    if(mHandle != nullptr) {
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    }
+    if(g2d_open(&mHandle) < 0) {
+        std::cerr << "Failed to open the video accelerator" << "\n";
+        mHandle = nullptr;
+        return G2dPixelFormatConverterStatus::DEVICE_ERROR;
+    }
+    return G2dPixelFormatConverterStatus::SUCCESS;
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::closeSession() {
+    G2dPixelFormatConverterStatus status = G2dPixelFormatConverterStatus::SUCCESS;
+    if(!mBufferPool.clear()) {
+        std::cerr << "Failed to free buffers" << "\n";
+        status = G2dPixelFormatConverterStatus::MEMORY_DEALLOCATION_ERROR;
+    }
+    if(mHandle != nullptr) {
+        if(g2d_close(mHandle) < 0) {
+            std::cerr << "Failed to close the video accelerator" << "\n";
+            status = G2dPixelFormatConverterStatus::DEVICE_ERROR;
+        }
+        mHandle = nullptr;
+    }
+    return status;
+}
+
+bool G2dPixelFormatConverter::isSessionOpen() const {
+    return mHandle != nullptr;
+}
+
+void G2dPixelFormatConverter::enableResultCache(size_t maxBytes) {
+    mResultCache = std::make_unique<G2dConversionCache>(maxBytes);
+}
+
+void G2dPixelFormatConverter::disableResultCache() {
+    mResultCache.reset();
+}
+
+std::optional<G2dConversionCacheStats> G2dPixelFormatConverter::resultCacheStats() const {
+    if(!mResultCache) {
+        return {};
+    }
+    return mResultCache->stats();
+}
+
+void G2dPixelFormatConverter::setConversionBackend(G2dConversionBackend backend) {
+    mBackend = backend;
+}
+
+G2dConversionBackend G2dPixelFormatConverter::conversionBackend() const {
+    return mBackend;
+}
+
+void G2dPixelFormatConverter::setCpuConversionOptions(const G2dCpuConversionOptions& options) {
+    mCpuOptions = options;
+}
+
+void G2dPixelFormatConverter::setTuningTable(std::shared_ptr<const G2dTuningTable> table) {
+    mTuningTable = std::move(table);
+}
+
+G2dConversionBackend G2dPixelFormatConverter::resolveBackend(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    G2dCpuConversionOptions& cpuOptions
+) const
+{
+    cpuOptions = mCpuOptions;
+    if(mBackend != G2dConversionBackend::AUTO || !mTuningTable || srcWidth != destWidth || srcHeight != destHeight) {
+        return mBackend;
+    }
+
+    std::optional<G2dTunedConfiguration> tuned = mTuningTable->find({srcFormat, destFormat, srcWidth, srcHeight});
+    if(!tuned.has_value()) {
+        return mBackend;
+    }
+    cpuOptions = tuned->cpuOptions;
+    return tuned->backend;
+}
 
 G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
     OrqaG2dFormat srcFormat,
@@ -14,7 +135,76 @@ G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
     size_t srcWidth,
     size_t srcHeight,
     size_t destWidth,
-    size_t destHeight
+    size_t destHeight,
+    std::span<const G2dOverlayLayer> overlays
+)
+{
+    std::optional<size_t> destSize = G2dFormatManager::getFrameSize(destFormat, destWidth, destHeight);
+    if(!destSize.has_value()) {
+        std::cerr << "Invalid source or destination format" << "\n";
+        return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+    }
+
+    // reserve space for the destination buffer
+    destBuffer.resize(*destSize, 0);
+
+    return convertImage(
+        srcFormat,
+        destFormat,
+        std::span<const uint8_t>(srcBuffer),
+        std::span<uint8_t>(destBuffer),
+        srcWidth,
+        srcHeight,
+        destWidth,
+        destHeight,
+        overlays
+    );
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    const G2dFrameBuffer& srcBuffer,
+    G2dFrameBuffer& destBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    std::span<const G2dOverlayLayer> overlays
+)
+{
+    std::optional<size_t> destSize = G2dFormatManager::getFrameSize(destFormat, destWidth, destHeight);
+    if(!destSize.has_value()) {
+        std::cerr << "Invalid source or destination format" << "\n";
+        return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+    }
+
+    // the converted frame overwrites every byte, so the buffer is not zeroed
+    destBuffer.resize(*destSize);
+
+    return convertImage(
+        srcFormat,
+        destFormat,
+        std::span<const uint8_t>(srcBuffer),
+        std::span<uint8_t>(destBuffer),
+        srcWidth,
+        srcHeight,
+        destWidth,
+        destHeight,
+        overlays
+    );
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    std::span<const uint8_t> srcBuffer,
+    std::span<uint8_t> destBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    size_t destWidth,
+    size_t destHeight,
+    std::span<const G2dOverlayLayer> overlays
 )
 {
     std::optional<G2dFormatMetadata> srcG2dFormat = G2dFormatManager::getFormatMetadata(srcFormat);
@@ -24,43 +214,100 @@ G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
         return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
     }
 
+    const bool sameSize = srcWidth == destWidth && srcHeight == destHeight;
+    G2dCpuConversionOptions cpuOptions;
+    const G2dConversionBackend backend = resolveBackend(srcFormat, destFormat, srcWidth, srcHeight, destWidth, destHeight, cpuOptions);
+
+    const bool useCpu =
+        backend != G2dConversionBackend::DEVICE && sameSize &&
+        G2dCpuConverter::isConversionSupported(srcFormat, destFormat, srcWidth, srcHeight);
+
     if(
-        G2dFormatManager::isFormatConversionSupported(srcG2dFormat->format, destG2dFormat->format) 
-            != FormatManagerStatus::SUCCESS
+        (backend == G2dConversionBackend::CPU && !useCpu) ||
+        (
+            !useCpu &&
+            (
+                !srcG2dFormat->deviceSupported || !destG2dFormat->deviceSupported ||
+                G2dFormatManager::isFormatConversionSupported(srcG2dFormat->format, destG2dFormat->format)
+                    != FormatManagerStatus::SUCCESS
+            )
+        )
     ) {
         std::cerr << "Image conversion failed due to unsupported format pair." << "\n";
         return G2dPixelFormatConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
     }
 
-    void* handle = nullptr;
-    struct g2d_surface srcSurface {};
-    struct g2d_surface destSurface {};
-
-    // set up the src buffer on the GPU
-    g2d_buf* srcG2dBuf = g2d_alloc(
-        static_cast<int>(srcBuffer.size()), 
-        static_cast<int>(G2dBufferCacheable::NON_CACHEABLE)
-    );
-    std::memcpy(srcG2dBuf->buf_vaddr, srcBuffer.data(), srcBuffer.size());
+    const std::optional<size_t> srcFrameSize = G2dFormatManager::getFrameSize(srcFormat, srcWidth, srcHeight);
+    const std::optional<size_t> destFrameSize = G2dFormatManager::getFrameSize(destFormat, destWidth, destHeight);
+    if(
+        !srcFrameSize.has_value() || !destFrameSize.has_value() ||
+        srcBuffer.size() < *srcFrameSize || destBuffer.size() < *destFrameSize
+    ) {
+        std::cerr << "Source or destination buffer is too small for the given image size" << "\n";
+        return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+    }
+    const size_t srcSize = *srcFrameSize;
+    const size_t destSize = *destFrameSize;
+    if(!overlaysFit(overlays)) {
+        std::cerr << "Overlay buffer is too small for the given overlay size" << "\n";
+        return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+    }
 
-    // reserve space for the destination buffer
-    destBuffer.resize(
-        destWidth* destHeight * static_cast<size_t>(destG2dFormat->bpp / 8), 
-        0
-    );
+    // the cache key does not cover the overlays, so frames with overlays are never cached. It does cover
+    // the backend, so a result of the accelerator is never returned once the CPU is chosen, or the reverse
+    std::optional<G2dConversionCacheKey> cacheKey;
+    if(mResultCache && overlays.empty()) {
+        cacheKey = G2dConversionCache::makeKey(
+            srcFormat,
+            destFormat,
+            srcBuffer.first(srcSize),
+            srcWidth,
+            srcHeight,
+            destWidth,
+            destHeight,
+            useCpu
+        );
+        std::span<const uint8_t> cached = mResultCache->lookup(*cacheKey);
+        if(cached.size() == destSize) {
+            std::memcpy(destBuffer.data(), cached.data(), destSize);
+            return G2dPixelFormatConverterStatus::SUCCESS;
+        }
+    }
 
-    // set up the dest buffer on the GPU
-    g2d_buf* destG2dBuf = g2d_alloc(
-        static_cast<int>(destBuffer.size()), 
-        static_cast<int>(G2dBufferCacheable::NON_CACHEABLE)
-    );
+    if(useCpu) {
+        // overlays are blended into each band of rows right after it is converted
+        const G2dConversionOutput output {destFormat, destWidth, destHeight, destBuffer, overlays};
+        const G2dCpuConverterStatus cpuStatus = overlays.empty()
+            ? G2dCpuConverter::convertImage(srcFormat, destFormat, srcBuffer, destBuffer, srcWidth, srcHeight, cpuOptions)
+            : G2dCpuConverter::convertImage(srcFormat, srcBuffer, srcWidth, srcHeight, std::span(&output, 1), cpuOptions);
+        if(cpuStatus != G2dCpuConverterStatus::SUCCESS) {
+            return G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+        }
+        if(cacheKey.has_value()) {
+            mResultCache->insert(*cacheKey, destBuffer.first(destSize));
+        }
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    }
 
-    if(g2d_open(&handle) < 0) {
-        std::cerr << "Failed to open the video accelerator" << "\n";
+    const bool ownsSession = !isSessionOpen();
+    if(ownsSession && openSession() != G2dPixelFormatConverterStatus::SUCCESS) {
         return G2dPixelFormatConverterStatus::DEVICE_ERROR;
     }
 
-    if(
+    G2dPixelFormatConverterStatus status = G2dPixelFormatConverterStatus::SUCCESS;
+    struct g2d_surface srcSurface {};
+    struct g2d_surface destSurface {};
+    std::vector<g2d_buf*> overlayBuffers;
+    const bool blendOnDevice = !isYuvFormat(destG2dFormat->format);
+
+    // set up the src and dest buffers on the GPU
+    g2d_buf* srcG2dBuf = mBufferPool.acquire(srcSize);
+    g2d_buf* destG2dBuf = mBufferPool.acquire(destSize);
+
+    if(srcG2dBuf == nullptr || destG2dBuf == nullptr) {
+        status = G2dPixelFormatConverterStatus::MEMORY_ALLOCATION_ERROR;
+    }
+    else if(
         setSourceFormatSurface(
             srcG2dFormat->format,
             srcSurface, 
@@ -70,9 +317,9 @@ G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
         ) != G2dPixelFormatConverterStatus::SUCCESS
     ) {
         std::cerr << "Failed to set source surface" << "\n";
-        return G2dPixelFormatConverterStatus::SURFACE_ERROR;
+        status = G2dPixelFormatConverterStatus::SURFACE_ERROR;
     }
-    if(
+    else if(
         setDestinationFormatSurface(
             destG2dFormat->format, 
             destSurface, destG2dBuf, 
@@ -82,33 +329,394 @@ G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
         != G2dPixelFormatConverterStatus::SUCCESS
     ) {
         std::cerr << "Failed to set destination surface" << "\n";
-        return G2dPixelFormatConverterStatus::SURFACE_ERROR;
+        status = G2dPixelFormatConverterStatus::SURFACE_ERROR;
     }
+    else {
+        std::memcpy(srcG2dBuf->buf_vaddr, srcBuffer.data(), srcSize);
 
-    if(g2d_blit(handle, &srcSurface, &destSurface) < 0) {
-        std::cerr << "This type of conversion is currently not supported" << "\n";
-        return G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+        if(g2d_blit(mHandle, &srcSurface, &destSurface) < 0) {
+            std::cerr << "This type of conversion is currently not supported" << "\n";
+            status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+        }
+        else if(
+            blendOnDevice &&
+            blitOverlays(destSurface, destWidth, destHeight, overlays, overlayBuffers) != G2dPixelFormatConverterStatus::SUCCESS
+        ) {
+            status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+        }
+
+        if(g2d_finish(mHandle) < 0) {
+            std::cerr << "Failed to finish the g2d operation" << "\n";
+            if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+                status = G2dPixelFormatConverterStatus::FINISH_OPERATION_ERROR;
+            }
+        }
+        else if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+            g2d_flush(mHandle);
+
+            // copy the dest buffer on the GPU to main memory
+            std::memcpy(destBuffer.data(), destG2dBuf->buf_vaddr, destSize);
+
+            // the device does not blend into YUV, so the overlaid rectangles are blended on the CPU
+            if(
+                !blendOnDevice && !overlays.empty() &&
+                G2dCpuConverter::blendOverlays(destFormat, destBuffer, destWidth, destHeight, overlays) != G2dCpuConverterStatus::SUCCESS
+            ) {
+                status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+            }
+        }
+    }
+
+    // clean up
+    bool overlaysReleased = true;
+    for(g2d_buf* overlayBuf : overlayBuffers) {
+        overlaysReleased = mBufferPool.release(overlayBuf) && overlaysReleased;
     }
-    if(g2d_finish(handle) < 0) {
+    const bool srcReleased = mBufferPool.release(srcG2dBuf);
+    const bool destReleased = mBufferPool.release(destG2dBuf);
+    if(!srcReleased || !destReleased || !overlaysReleased) {
+        std::cerr << "Failed to free buffers" << "\n";
+        status = G2dPixelFormatConverterStatus::MEMORY_DEALLOCATION_ERROR;
+    }
+
+    if(ownsSession) {
+        const G2dPixelFormatConverterStatus closeStatus = closeSession();
+        if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+            status = closeStatus;
+        }
+    }
+
+    if(cacheKey.has_value() && status == G2dPixelFormatConverterStatus::SUCCESS) {
+        mResultCache->insert(*cacheKey, destBuffer.first(destSize));
+    }
+
+    return status;
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImage(
+    OrqaG2dFormat srcFormat,
+    std::span<const uint8_t> srcBuffer,
+    size_t srcWidth,
+    size_t srcHeight,
+    std::span<const G2dConversionOutput> outputs
+)
+{
+    std::optional<G2dFormatMetadata> srcG2dFormat = G2dFormatManager::getFormatMetadata(srcFormat);
+    if(!srcG2dFormat.has_value()) {
+        std::cerr << "Invalid source or destination format" << "\n";
+        return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+    }
+
+    const std::optional<size_t> srcFrameSize = G2dFormatManager::getFrameSize(srcFormat, srcWidth, srcHeight);
+    if(!srcFrameSize.has_value() || srcBuffer.size() < *srcFrameSize) {
+        std::cerr << "Source or destination buffer is too small for the given image size" << "\n";
+        return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+    }
+    const size_t srcSize = *srcFrameSize;
+
+    struct DeviceOutput {
+        G2dConversionOutput output;
+        g2d_format format;
+        size_t size;
+        g2d_buf* buf;
+    };
+
+    std::vector<G2dConversionOutput> cpuOutputs;
+    std::vector<DeviceOutput> deviceOutputs;
+    G2dCpuConversionOptions cpuOptions = mCpuOptions;
+
+    for(const G2dConversionOutput& output : outputs) {
+        std::optional<G2dFormatMetadata> destG2dFormat = G2dFormatManager::getFormatMetadata(output.format);
+        if(!destG2dFormat.has_value()) {
+            std::cerr << "Invalid source or destination format" << "\n";
+            return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
+        }
+
+        G2dCpuConversionOptions outputCpuOptions;
+        const G2dConversionBackend backend =
+            resolveBackend(srcFormat, output.format, srcWidth, srcHeight, output.width, output.height, outputCpuOptions);
+        const bool useCpu =
+            backend != G2dConversionBackend::DEVICE &&
+            srcWidth == output.width && srcHeight == output.height &&
+            G2dCpuConverter::isConversionSupported(srcFormat, output.format, srcWidth, srcHeight);
+
+        if(
+            (backend == G2dConversionBackend::CPU && !useCpu) ||
+            (
+                !useCpu &&
+                (
+                    !srcG2dFormat->deviceSupported || !destG2dFormat->deviceSupported ||
+                    G2dFormatManager::isFormatConversionSupported(srcG2dFormat->format, destG2dFormat->format)
+                        != FormatManagerStatus::SUCCESS
+                )
+            )
+        ) {
+            std::cerr << "Image conversion failed due to unsupported format pair." << "\n";
+            return G2dPixelFormatConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+        }
+
+        const std::optional<size_t> destFrameSize = G2dFormatManager::getFrameSize(output.format, output.width, output.height);
+        if(!destFrameSize.has_value() || output.buffer.size() < *destFrameSize || !overlaysFit(output.overlays)) {
+            std::cerr << "Destination or overlay buffer is too small for the given image size" << "\n";
+            return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+        }
+        const size_t destSize = *destFrameSize;
+
+        if(useCpu) {
+            // the CPU outputs share one pass over the source, threaded like the first of them
+            if(cpuOutputs.empty()) {
+                cpuOptions = outputCpuOptions;
+            }
+            cpuOutputs.push_back(output);
+        }
+        else {
+            deviceOutputs.push_back({output, destG2dFormat->format, destSize, nullptr});
+        }
+    }
+
+    auto convertOnCpu = [&]() {
+        if(
+            !cpuOutputs.empty() &&
+            G2dCpuConverter::convertImage(srcFormat, srcBuffer, srcWidth, srcHeight, cpuOutputs, cpuOptions)
+                != G2dCpuConverterStatus::SUCCESS
+        ) {
+            return G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+        }
+        return G2dPixelFormatConverterStatus::SUCCESS;
+    };
+
+    if(deviceOutputs.empty()) {
+        return convertOnCpu();
+    }
+
+    const bool ownsSession = !isSessionOpen();
+    if(ownsSession && openSession() != G2dPixelFormatConverterStatus::SUCCESS) {
+        return G2dPixelFormatConverterStatus::DEVICE_ERROR;
+    }
+
+    G2dPixelFormatConverterStatus status = G2dPixelFormatConverterStatus::SUCCESS;
+    struct g2d_surface srcSurface {};
+    size_t blitCount = 0;
+    std::vector<g2d_buf*> overlayBuffers;
+
+    // the source is uploaded once and every device output is blitted from the same buffer
+    g2d_buf* srcG2dBuf = mBufferPool.acquire(srcSize);
+    if(srcG2dBuf == nullptr) {
+        status = G2dPixelFormatConverterStatus::MEMORY_ALLOCATION_ERROR;
+    }
+    else if(
+        setSourceFormatSurface(
+            srcG2dFormat->format,
+            srcSurface,
+            srcG2dBuf,
+            static_cast<int>(srcWidth),
+            static_cast<int>(srcHeight)
+        ) != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        std::cerr << "Failed to set source surface" << "\n";
+        status = G2dPixelFormatConverterStatus::SURFACE_ERROR;
+    }
+    else {
+        std::memcpy(srcG2dBuf->buf_vaddr, srcBuffer.data(), srcSize);
+
+        for(DeviceOutput& deviceOutput : deviceOutputs) {
+            struct g2d_surface destSurface {};
+            deviceOutput.buf = mBufferPool.acquire(deviceOutput.size);
+            if(deviceOutput.buf == nullptr) {
+                status = G2dPixelFormatConverterStatus::MEMORY_ALLOCATION_ERROR;
+                break;
+            }
+            if(
+                setDestinationFormatSurface(
+                    deviceOutput.format,
+                    destSurface,
+                    deviceOutput.buf,
+                    static_cast<int>(deviceOutput.output.width),
+                    static_cast<int>(deviceOutput.output.height)
+                ) != G2dPixelFormatConverterStatus::SUCCESS
+            ) {
+                std::cerr << "Failed to set destination surface" << "\n";
+                status = G2dPixelFormatConverterStatus::SURFACE_ERROR;
+                break;
+            }
+            if(g2d_blit(mHandle, &srcSurface, &destSurface) < 0) {
+                std::cerr << "This type of conversion is currently not supported" << "\n";
+                status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+                break;
+            }
+            blitCount++;
+            if(
+                !isYuvFormat(deviceOutput.format) &&
+                blitOverlays(destSurface, deviceOutput.output.width, deviceOutput.output.height, deviceOutput.output.overlays, overlayBuffers)
+                    != G2dPixelFormatConverterStatus::SUCCESS
+            ) {
+                status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+                break;
+            }
+        }
+    }
+
+    if(blitCount > 0) {
+        g2d_flush(mHandle);
+    }
+
+    // the CPU outputs are converted while the accelerator works through the blits
+    if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+        status = convertOnCpu();
+    }
+
+    if(blitCount > 0 && g2d_finish(mHandle) < 0) {
         std::cerr << "Failed to finish the g2d operation" << "\n";
-        return G2dPixelFormatConverterStatus::FINISH_OPERATION_ERROR;
+        if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+            status = G2dPixelFormatConverterStatus::FINISH_OPERATION_ERROR;
+        }
+    }
+
+    if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+        // copy the dest buffers on the GPU to main memory
+        for(const DeviceOutput& deviceOutput : deviceOutputs) {
+            const G2dConversionOutput& output = deviceOutput.output;
+            std::memcpy(output.buffer.data(), deviceOutput.buf->buf_vaddr, deviceOutput.size);
+
+            // the device does not blend into YUV, so the overlaid rectangles are blended on the CPU
+            if(
+                isYuvFormat(deviceOutput.format) && !output.overlays.empty() &&
+                G2dCpuConverter::blendOverlays(output.format, output.buffer, output.width, output.height, output.overlays)
+                    != G2dCpuConverterStatus::SUCCESS
+            ) {
+                status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+            }
+        }
     }
-    g2d_flush(handle);
 
-    // copy the rgb buffer on the GPU to main memory
-    std::memcpy(destBuffer.data(), destG2dBuf->buf_vaddr, destBuffer.size());
- 
     // clean up
-    if(g2d_free(srcG2dBuf) < 0 || g2d_free(destG2dBuf) < 0) {
+    bool released = mBufferPool.release(srcG2dBuf);
+    for(g2d_buf* overlayBuf : overlayBuffers) {
+        released = mBufferPool.release(overlayBuf) && released;
+    }
+    for(const DeviceOutput& deviceOutput : deviceOutputs) {
+        released = mBufferPool.release(deviceOutput.buf) && released;
+    }
+    if(!released) {
         std::cerr << "Failed to free buffers" << "\n";
-        return G2dPixelFormatConverterStatus::MEMORY_DEALLOCATION_ERROR;
+        status = G2dPixelFormatConverterStatus::MEMORY_DEALLOCATION_ERROR;
     }
 
-    if(g2d_close(handle) < 0) { 
-        std::cerr << "Failed to close the video accelerator" << "\n";
-        return G2dPixelFormatConverterStatus::DEVICE_ERROR;
+    if(ownsSession) {
+        const G2dPixelFormatConverterStatus closeStatus = closeSession();
+        if(status == G2dPixelFormatConverterStatus::SUCCESS) {
+            status = closeStatus;
+        }
+    }
+
+    return status;
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::blitOverlays(
+    const struct g2d_surface& destSurface,
+    size_t destWidth,
+    size_t destHeight,
+    std::span<const G2dOverlayLayer> overlays,
+    std::vector<g2d_buf*>& overlayBuffers
+)
+{
+    G2dPixelFormatConverterStatus status = G2dPixelFormatConverterStatus::SUCCESS;
+    bool blending = false;
+    bool globalAlpha = false;
+
+    for(const G2dOverlayLayer& layer : overlays) {
+        if(layer.left >= destWidth || layer.top >= destHeight || layer.width == 0 || layer.height == 0 || layer.globalAlpha == 0) {
+            continue;
+        }
+
+        const size_t overlaySize = layer.width * layer.height * 4;
+        g2d_buf* overlayBuf = mBufferPool.acquire(overlaySize);
+        if(overlayBuf == nullptr) {
+            status = G2dPixelFormatConverterStatus::MEMORY_ALLOCATION_ERROR;
+            break;
+        }
+        overlayBuffers.push_back(overlayBuf);
+        std::memcpy(overlayBuf->buf_vaddr, layer.pixels.data(), overlaySize);
+
+        // parts of the overlay outside the destination are cut off
+        const int visibleWidth = static_cast<int>(std::min(layer.width, destWidth - layer.left));
+        const int visibleHeight = static_cast<int>(std::min(layer.height, destHeight - layer.top));
+
+        struct g2d_surface overlaySurface {};
+        overlaySurface.format = G2D_RGBA8888;
+        overlaySurface.planes[0] = overlayBuf->buf_paddr;
+        overlaySurface.left = 0;
+        overlaySurface.top = 0;
+        overlaySurface.right = visibleWidth;
+        overlaySurface.bottom = visibleHeight;
+        overlaySurface.stride = static_cast<int>(layer.width);
+        overlaySurface.width = static_cast<int>(layer.width);
+        overlaySurface.height = static_cast<int>(layer.height);
+        overlaySurface.rot = G2D_ROTATION_0;
+        overlaySurface.blendfunc = G2D_SRC_ALPHA;
+        overlaySurface.global_alpha = layer.globalAlpha;
+
+        struct g2d_surface targetSurface = destSurface;
+        targetSurface.left = static_cast<int>(layer.left);
+        targetSurface.top = static_cast<int>(layer.top);
+        targetSurface.right = static_cast<int>(layer.left) + visibleWidth;
+        targetSurface.bottom = static_cast<int>(layer.top) + visibleHeight;
+        targetSurface.blendfunc = G2D_ONE_MINUS_SRC_ALPHA;
+
+        if(!blending) {
+            // without blending the overlay would be copied opaque over the frame
+            blending = g2d_enable(mHandle, G2D_BLEND) >= 0;
+            globalAlpha = blending && g2d_enable(mHandle, G2D_GLOBAL_ALPHA) >= 0;
+            if(!globalAlpha) {
+                std::cerr << "Failed to enable blending for the overlays" << "\n";
+                status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+                break;
+            }
+        }
+        if(g2d_blit(mHandle, &overlaySurface, &targetSurface) < 0) {
+            std::cerr << "Failed to blend the overlay" << "\n";
+            status = G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+            break;
+        }
+    }
+
+    // blending left on would also apply to the later conversions of the session
+    if(globalAlpha && g2d_disable(mHandle, G2D_GLOBAL_ALPHA) < 0) {
+        std::cerr << "Failed to disable global alpha after the overlays" << "\n";
+    }
+    if(blending && g2d_disable(mHandle, G2D_BLEND) < 0) {
+        std::cerr << "Failed to disable blending after the overlays" << "\n";
+    }
+    return status;
+}
+
+G2dPixelFormatConverterStatus G2dPixelFormatConverter::convertImageInPlace(
+    OrqaG2dFormat srcFormat,
+    OrqaG2dFormat destFormat,
+    std::span<uint8_t> buffer,
+    size_t width,
+    size_t height
+)
+{
+    if(!G2dFormatManager::getFormatMetadata(srcFormat).has_value() || !G2dFormatManager::getFormatMetadata(destFormat).has_value()) {
+        std::cerr << "Invalid source or destination format" << "\n";
+        return G2dPixelFormatConverterStatus::INVALID_FORMAT_ERROR;
     }
 
+    if(!G2dCpuConverter::isInPlaceConversionSupported(srcFormat, destFormat, width, height)) {
+        std::cerr << "Image conversion failed due to unsupported format pair." << "\n";
+        return G2dPixelFormatConverterStatus::UNSUPPORTED_CONVERSION_ERROR;
+    }
+
+    const std::optional<size_t> frameSize = G2dFormatManager::getFrameSize(srcFormat, width, height);
+    if(!frameSize.has_value() || buffer.size() < *frameSize) {
+        std::cerr << "Buffer is too small for the given image size" << "\n";
+        return G2dPixelFormatConverterStatus::BUFFER_SIZE_ERROR;
+    }
+
+    if(G2dCpuConverter::convertImageInPlace(srcFormat, destFormat, buffer, width, height) != G2dCpuConverterStatus::SUCCESS) {
+        return G2dPixelFormatConverterStatus::GENERAL_CONVERSION_ERROR;
+    }
     return G2dPixelFormatConverterStatus::SUCCESS;
 }
 
@@ -0,0 +1,125 @@
+#include "G2dSharedFrame.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iostream>
+#include <utility>
+
+G2dSharedFrame::~G2dSharedFrame() {
+    release();
+}
+
+G2dSharedFrame::G2dSharedFrame(G2dSharedFrame&& other) noexcept
+    : mFd(std::exchange(other.mFd, -1)),
+      mSize(std::exchange(other.mSize, 0)),
+      mData(std::exchange(other.mData, nullptr)) {}
+
+G2dSharedFrame& G2dSharedFrame::operator=(G2dSharedFrame&& other) noexcept {
+    if(this != &other) {
+        release();
+        mFd = std::exchange(other.mFd, -1);
+        mSize = std::exchange(other.mSize, 0);
+        mData = std::exchange(other.mData, nullptr);
+    }
+    return *this;
+}
+
+G2dSharedFrameStatus G2dSharedFrame::allocate(size_t size) {
+    release();
+
+    const int fd = memfd_create("g2d-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if(fd < 0) {
+        std::cerr << "Failed to create a shared memory frame" << "\n";
+        return G2dSharedFrameStatus::ALLOCATION_ERROR;
+    }
+    if(ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        std::cerr << "Failed to resize the shared memory frame" << "\n";
+        close(fd);
+        return G2dSharedFrameStatus::ALLOCATION_ERROR;
+    }
+    // the other process maps the frame too, and must be able to trust that it never shrinks under it
+    if(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+        std::cerr << "Failed to seal the shared memory frame" << "\n";
+        close(fd);
+        return G2dSharedFrameStatus::ALLOCATION_ERROR;
+    }
+
+    return attach(fd, size, true);
+}
+
+G2dSharedFrameStatus G2dSharedFrame::attach(int fd, size_t size, bool writable) {
+    release();
+
+    // a file that can still shrink could be truncated by the other process after the size
+    // check, and touching the mapping past the new end would then raise SIGBUS
+    const int seals = fcntl(fd, F_GET_SEALS);
+    if(seals < 0 || (seals & F_SEAL_SHRINK) == 0) {
+        std::cerr << "Shared memory frame is not sealed against shrinking" << "\n";
+        close(fd);
+        return G2dSharedFrameStatus::MAPPING_ERROR;
+    }
+
+    struct stat fileStat {};
+    if(fstat(fd, &fileStat) < 0 || static_cast<size_t>(fileStat.st_size) < size || size == 0) {
+        std::cerr << "Shared memory frame is smaller than requested" << "\n";
+        close(fd);
+        return G2dSharedFrameStatus::MAPPING_ERROR;
+    }
+
+    void* data = mmap(
+        nullptr,
+        size,
+        writable ? PROT_READ | PROT_WRITE : PROT_READ,
+        MAP_SHARED,
+        fd,
+        0
+    );
+    if(data == MAP_FAILED) {
+        std::cerr << "Failed to map the shared memory frame" << "\n";
+        close(fd);
+        return G2dSharedFrameStatus::MAPPING_ERROR;
+    }
+
+    mFd = fd;
+    mSize = size;
+    mData = static_cast<uint8_t*>(data);
+    return G2dSharedFrameStatus::SUCCESS;
+}
+
+void G2dSharedFrame::release() {
+    if(mData != nullptr) {
+        munmap(mData, mSize);
+        mData = nullptr;
+    }
+    if(mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+    mSize = 0;
+}
+
+int G2dSharedFrame::fd() const {
+    return mFd;
+}
+
+size_t G2dSharedFrame::size() const {
+    return mSize;
+}
+
+uint8_t* G2dSharedFrame::data() {
+    return mData;
+}
+
+const uint8_t* G2dSharedFrame::data() const {
+    return mData;
+}
+
+std::span<uint8_t> G2dSharedFrame::span() {
+    return {mData, mSize};
+}
+
+std::span<const uint8_t> G2dSharedFrame::span() const {
+    return {mData, mSize};
+}
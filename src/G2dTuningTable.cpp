@@ -0,0 +1,115 @@
+#include "G2dTuningTable.hpp"
+#include "G2dFormatManager.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* backendName(G2dConversionBackend backend) {
+    return backend == G2dConversionBackend::CPU ? "CPU" : "DEVICE";
+}
+
+std::optional<G2dConversionBackend> backendFromName(const std::string& name) {
+    if(name == "CPU") {
+        return G2dConversionBackend::CPU;
+    }
+    if(name == "DEVICE") {
+        return G2dConversionBackend::DEVICE;
+    }
+    return {};
+}
+
+}
+
+std::optional<G2dTunedConfiguration> G2dTuningTable::find(const G2dTuningKey& key) const {
+    auto entry = std::find_if(mEntries.begin(), mEntries.end(), [&](const auto& candidate) {
+        return candidate.first == key;
+    });
+    if(entry == mEntries.end()) {
+        return {};
+    }
+    return entry->second;
+}
+
+void G2dTuningTable::set(const G2dTuningKey& key, const G2dTunedConfiguration& configuration) {
+    auto entry = std::find_if(mEntries.begin(), mEntries.end(), [&](const auto& candidate) {
+        return candidate.first == key;
+    });
+    if(entry == mEntries.end()) {
+        mEntries.emplace_back(key, configuration);
+    }
+    else {
+        entry->second = configuration;
+    }
+}
+
+size_t G2dTuningTable::size() const {
+    return mEntries.size();
+}
+
+G2dTuningStatus G2dTuningTable::save(const std::string& path) const {
+    std::ofstream file(path);
+    if(!file.is_open()) {
+        std::cerr << "Failed to open tuning file: " << path << "\n";
+        return G2dTuningStatus::FILE_ERROR;
+    }
+
+    file << "# source destination width height backend threads band_rows microseconds" << "\n";
+    for(const auto& [key, configuration] : mEntries) {
+        file << G2dFormatManager::getFormatString(key.srcFormat).value_or("?") << " "
+             << G2dFormatManager::getFormatString(key.destFormat).value_or("?") << " "
+             << key.width << " "
+             << key.height << " "
+             << backendName(configuration.backend) << " "
+             << configuration.cpuOptions.threadCount << " "
+             << configuration.cpuOptions.bandRows << " "
+             << configuration.microseconds << "\n";
+    }
+
+    if(!file.good()) {
+        std::cerr << "Failed to write tuning file: " << path << "\n";
+        return G2dTuningStatus::FILE_ERROR;
+    }
+    return G2dTuningStatus::SUCCESS;
+}
+
+G2dTuningStatus G2dTuningTable::load(const std::string& path) {
+    std::ifstream file(path);
+    if(!file.is_open()) {
+        return G2dTuningStatus::FILE_ERROR;
+    }
+
+    std::string line;
+    while(std::getline(file, line)) {
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string srcName;
+        std::string destName;
+        std::string backend;
+        G2dTuningKey key {};
+        G2dTunedConfiguration configuration;
+        fields >> srcName >> destName >> key.width >> key.height >> backend
+               >> configuration.cpuOptions.threadCount >> configuration.cpuOptions.bandRows
+               >> configuration.microseconds;
+
+        std::optional<OrqaG2dFormat> srcFormat = G2dFormatManager::getFormatEnumFromString(srcName);
+        std::optional<OrqaG2dFormat> destFormat = G2dFormatManager::getFormatEnumFromString(destName);
+        std::optional<G2dConversionBackend> backendValue = backendFromName(backend);
+        if(fields.fail() || !srcFormat.has_value() || !destFormat.has_value() || !backendValue.has_value()) {
+            std::cerr << "Malformed line in tuning file " << path << ": " << line << "\n";
+            return G2dTuningStatus::PARSE_ERROR;
+        }
+
+        key.srcFormat = *srcFormat;
+        key.destFormat = *destFormat;
+        configuration.backend = *backendValue;
+        set(key, configuration);
+    }
+    return G2dTuningStatus::SUCCESS;
+}
@@ -0,0 +1,189 @@
+#include "G2dUnixSocket.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    bool fillAddress(const std::string& path, sockaddr_un& address) {
+        if(path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Socket path is too long: " << path << "\n";
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+}
+
+G2dUnixSocketStatus G2dUnixSocket::listenOn(const std::string& path, int& fd) {
+    sockaddr_un address {};
+    if(!fillAddress(path, address)) {
+        return G2dUnixSocketStatus::SOCKET_ERROR;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0) {
+        std::cerr << "Failed to create socket" << "\n";
+        return G2dUnixSocketStatus::SOCKET_ERROR;
+    }
+
+    unlink(path.c_str());
+    if(
+        bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(fd, SOMAXCONN) < 0
+    ) {
+        std::cerr << "Failed to listen on socket: " << path << "\n";
+        close(fd);
+        fd = -1;
+        return G2dUnixSocketStatus::SOCKET_ERROR;
+    }
+
+    return G2dUnixSocketStatus::SUCCESS;
+}
+
+G2dUnixSocketStatus G2dUnixSocket::connectTo(const std::string& path, int& fd) {
+    sockaddr_un address {};
+    if(!fillAddress(path, address)) {
+        return G2dUnixSocketStatus::SOCKET_ERROR;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0) {
+        std::cerr << "Failed to create socket" << "\n";
+        return G2dUnixSocketStatus::SOCKET_ERROR;
+    }
+
+    if(connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Failed to connect to socket: " << path << "\n";
+        close(fd);
+        fd = -1;
+        return G2dUnixSocketStatus::SOCKET_ERROR;
+    }
+
+    return G2dUnixSocketStatus::SUCCESS;
+}
+
+G2dUnixSocketStatus G2dUnixSocket::sendMessage(
+    int socketFd,
+    std::span<const std::byte> data,
+    std::span<const int> fds
+) {
+    if(fds.size() > MaxFds) {
+        return G2dUnixSocketStatus::SEND_ERROR;
+    }
+
+    iovec iov {};
+    iov.iov_base = const_cast<std::byte*>(data.data());
+    iov.iov_len = data.size();
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MaxFds)] {};
+    msghdr message {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    if(!fds.empty()) {
+        message.msg_control = control;
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+    }
+
+    // the descriptors travel with the first byte, the rest is plain stream data
+    size_t sent = 0;
+    while(sent < data.size()) {
+        const ssize_t result = sendmsg(socketFd, &message, MSG_NOSIGNAL);
+        if(result < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return G2dUnixSocketStatus::SEND_ERROR;
+        }
+        sent += static_cast<size_t>(result);
+        iov.iov_base = const_cast<std::byte*>(data.data()) + sent;
+        iov.iov_len = data.size() - sent;
+        message.msg_control = nullptr;
+        message.msg_controllen = 0;
+    }
+
+    return G2dUnixSocketStatus::SUCCESS;
+}
+
+G2dUnixSocketStatus G2dUnixSocket::receiveMessage(
+    int socketFd,
+    std::span<std::byte> data,
+    std::vector<int>& fds
+) {
+    fds.clear();
+
+    size_t received = 0;
+    const G2dUnixSocketStatus status = receiveAvailable(socketFd, data, received, fds);
+    if(status == G2dUnixSocketStatus::WOULD_BLOCK) {
+        // a non-blocking socket, or a blocking one whose receive timeout expired
+        for(int fd : fds) {
+            close(fd);
+        }
+        fds.clear();
+        return G2dUnixSocketStatus::RECEIVE_ERROR;
+    }
+    return status;
+}
+
+G2dUnixSocketStatus G2dUnixSocket::receiveAvailable(
+    int socketFd,
+    std::span<std::byte> data,
+    size_t& received,
+    std::vector<int>& fds
+) {
+    while(received < data.size()) {
+        iovec iov {};
+        iov.iov_base = data.data() + received;
+        iov.iov_len = data.size() - received;
+
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MaxFds)] {};
+        msghdr message {};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const ssize_t result = recvmsg(socketFd, &message, MSG_CMSG_CLOEXEC);
+        if(result < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                return G2dUnixSocketStatus::WOULD_BLOCK;
+            }
+            return G2dUnixSocketStatus::RECEIVE_ERROR;
+        }
+        if(result == 0) {
+            for(int fd : fds) {
+                close(fd);
+            }
+            fds.clear();
+            return G2dUnixSocketStatus::CONNECTION_CLOSED;
+        }
+
+        for(cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if(header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                const size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for(size_t i = 0; i < count; i++) {
+                    int fd = -1;
+                    std::memcpy(&fd, CMSG_DATA(header) + (i * sizeof(int)), sizeof(int));
+                    fds.push_back(fd);
+                }
+            }
+        }
+
+        received += static_cast<size_t>(result);
+    }
+
+    return G2dUnixSocketStatus::SUCCESS;
+}
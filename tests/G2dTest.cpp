@@ -1,10 +1,26 @@
 #include "G2dPixelFormatConverter.hpp"
 #include "G2dFormatManager.hpp"
 #include "FileReaderWriter.hpp"
+#include "G2dConversionServer.hpp"
+#include "G2dConversionClient.hpp"
+#include "G2dConcurrentConverter.hpp"
+#include "G2dBulkConverter.hpp"
+#include "G2dIncrementalConverter.hpp"
+#include "G2dAutotuner.hpp"
+#include "G2dFrameRingConverter.hpp"
+#include "G2dLumaPyramid.hpp"
+#include "G2dFrameScheduler.hpp"
+#include "G2dFrameHash.hpp"
 
 #include <vector>
+#include <string>
 #include <iostream>
 #include <functional>
+#include <thread>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <unistd.h>
 
 enum class G2dConvertTestSuiteStatus {
     SUCCESS = 0,
@@ -305,6 +321,892 @@ TestStatus YUYVToRGBAConversionTestWithResize() {
 
 } 
 
+TestStatus ConversionServerYUYVToRGBATest() {
+    G2dConversionServer server("/tmp/g2dconvert-test.sock");
+    if (server.start() != G2dConversionServerStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    std::thread serverThread([&server]() { server.run(); });
+
+    G2dConversionClient client("/tmp/g2dconvert-test.sock");
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> rgbaBuffer;
+    std::vector<uint8_t> rgbaExcpectedBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    fileReaderWriter.readFileRaw("tests/expected/yuyv.rgba", rgbaExcpectedBuffer);
+
+    G2dPixelFormatConverterStatus result = client.convertImage(
+        OrqaG2dFormat::FMT_YUYV, 
+        OrqaG2dFormat::FMT_RGBA8888, 
+        yuyvBuffer, 
+        rgbaBuffer, 
+        640, 
+        480,
+        640, 
+        480
+    );
+
+    client.disconnect();
+    server.stop();
+    serverThread.join();
+
+    if (result != G2dPixelFormatConverterStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    if (std::equal(rgbaBuffer.begin(), rgbaBuffer.end(), rgbaExcpectedBuffer.begin())) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus ConcurrentConverterYUYVToRGBATest() {
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> rgbaExcpectedBuffer;
+    std::vector<std::vector<uint8_t>> rgbaBuffers(8);
+
+    // declared after the buffers, so on an early return it finishes the queued jobs before they are freed
+    G2dConcurrentConverter converter(2);
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    fileReaderWriter.readFileRaw("tests/expected/yuyv.rgba", rgbaExcpectedBuffer);
+
+    // every producer thread submits its own frames
+    std::vector<std::future<G2dPixelFormatConverterStatus>> results(rgbaBuffers.size());
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < 4; t++) {
+        producers.emplace_back([&, t]() {
+            for (size_t i = t; i < rgbaBuffers.size(); i += 4) {
+                results[i] = converter.submit(
+                    OrqaG2dFormat::FMT_YUYV, 
+                    OrqaG2dFormat::FMT_RGBA8888, 
+                    yuyvBuffer, 
+                    rgbaBuffers[i], 
+                    640, 
+                    480,
+                    640, 
+                    480
+                );
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    for (size_t i = 0; i < rgbaBuffers.size(); i++) {
+        if (results[i].get() != G2dPixelFormatConverterStatus::SUCCESS) {
+            return TestStatus::GENERAL_TEST_FAILURE;
+        }
+        if (!std::equal(rgbaBuffers[i].begin(), rgbaBuffers[i].end(), rgbaExcpectedBuffer.begin())) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+    return TestStatus::PASS;
+}
+
+TestStatus BulkYUYVToRGBAConversionTest() {
+    G2dBulkConverter bulkConverter(2, 2, 4);
+    G2dBulkConversionSummary summary;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> rgbaBuffer;
+    std::vector<uint8_t> rgbaExcpectedBuffer;
+
+    // the output goes to a temporary directory, removed again before the result is checked
+    const std::filesystem::path outputDirectory =
+        std::filesystem::temp_directory_path() / ("g2d-bulk-test-" + std::to_string(getpid()));
+
+    G2dBulkConverterStatus result = bulkConverter.convertFiles(
+        OrqaG2dFormat::FMT_YUYV, 
+        OrqaG2dFormat::FMT_RGBA8888, 
+        {"tests/inputs/input.yuyv"},
+        outputDirectory.string(),
+        "rgba",
+        640, 
+        480,
+        640, 
+        480,
+        summary
+    );
+
+    if (result == G2dBulkConverterStatus::SUCCESS && summary.converted == 1) {
+        fileReaderWriter.readFileRaw((outputDirectory / "input.rgba").string(), rgbaBuffer);
+    }
+    std::error_code error;
+    std::filesystem::remove_all(outputDirectory, error);
+
+    if (result != G2dBulkConverterStatus::SUCCESS || summary.converted != 1) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    fileReaderWriter.readFileRaw("tests/expected/yuyv.rgba", rgbaExcpectedBuffer);
+    if (rgbaBuffer == rgbaExcpectedBuffer) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus CachedYUYVToRGBAConversionTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> rgbaBuffer;
+    std::vector<uint8_t> rgbaExcpectedBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    fileReaderWriter.readFileRaw("tests/expected/yuyv.rgba", rgbaExcpectedBuffer);
+
+    converter.enableResultCache(4 * 1024 * 1024);
+
+    // the second conversion of the same frame must be served from the cache
+    for (size_t i = 0; i < 2; i++) {
+        rgbaBuffer.clear();
+        G2dPixelFormatConverterStatus result = converter.convertImage(
+            OrqaG2dFormat::FMT_YUYV, 
+            OrqaG2dFormat::FMT_RGBA8888, 
+            yuyvBuffer, 
+            rgbaBuffer, 
+            640, 
+            480,
+            640, 
+            480
+        );
+        if (result != G2dPixelFormatConverterStatus::SUCCESS) {
+            return TestStatus::GENERAL_TEST_FAILURE;
+        }
+    }
+
+    std::optional<G2dConversionCacheStats> stats = converter.resultCacheStats();
+    if (!stats.has_value() || stats->hits != 1 || stats->misses != 1) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    if (std::equal(rgbaBuffer.begin(), rgbaBuffer.end(), rgbaExcpectedBuffer.begin())) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus FrameHashReferenceTest() {
+    // digests of the XXH64 reference implementation with seed 0
+    const std::vector<std::pair<std::string, uint64_t>> vectors = {
+        {"", 0xef46db3751d8e999ULL},
+        {"a", 0xd24ec4f1a98c6e5bULL},
+        {"abc", 0x44bc2cf5ad770999ULL},
+    };
+
+    for (const auto& [input, digest] : vectors) {
+        std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+        if (G2dFrameHash::hash64(data) != digest) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+    return TestStatus::PASS;
+}
+
+TestStatus IncrementalYUYVToRGBAConversionTest() {
+    G2dIncrementalConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> rgbaExcpectedBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    fileReaderWriter.readFileRaw("tests/expected/yuyv.rgba", rgbaExcpectedBuffer);
+
+    // the second frame is unchanged, so no tile may be reconverted
+    for (size_t i = 0; i < 2; i++) {
+        G2dPixelFormatConverterStatus result = converter.convertFrame(
+            OrqaG2dFormat::FMT_YUYV, 
+            OrqaG2dFormat::FMT_RGBA8888, 
+            yuyvBuffer, 
+            640, 
+            480
+        );
+        if (result != G2dPixelFormatConverterStatus::SUCCESS) {
+            return TestStatus::GENERAL_TEST_FAILURE;
+        }
+    }
+
+    if (converter.lastDirtyTileCount() != 0) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    std::span<const uint8_t> output = converter.output();
+    if (
+        output.size() != rgbaExcpectedBuffer.size() ||
+        !std::equal(output.begin(), output.end(), rgbaExcpectedBuffer.begin())
+    ) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+
+    // change two pixels of row 20, which lie in the second tile of the second tile row
+    std::vector<uint8_t> changedBuffer = yuyvBuffer;
+    const size_t changedOffset = (20 * 640 + 70) * 2;
+    for (size_t i = changedOffset; i < changedOffset + 4; i++) {
+        changedBuffer[i] ^= 0xFF;
+    }
+
+    G2dPixelFormatConverterStatus result = converter.convertFrame(
+        OrqaG2dFormat::FMT_YUYV, 
+        OrqaG2dFormat::FMT_RGBA8888, 
+        changedBuffer, 
+        640, 
+        480
+    );
+    if (result != G2dPixelFormatConverterStatus::SUCCESS || converter.lastDirtyTileCount() != 1) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    G2dPixelFormatConverter fullConverter;
+    std::vector<uint8_t> rgbaFullBuffer(rgbaExcpectedBuffer.size());
+    result = fullConverter.convertImage(
+        OrqaG2dFormat::FMT_YUYV, 
+        OrqaG2dFormat::FMT_RGBA8888, 
+        changedBuffer, 
+        rgbaFullBuffer, 
+        640, 
+        480,
+        640, 
+        480
+    );
+    if (result != G2dPixelFormatConverterStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    output = converter.output();
+    if (
+        output.size() == rgbaFullBuffer.size() &&
+        std::equal(output.begin(), output.end(), rgbaFullBuffer.begin())
+    ) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus CpuYUVRepackRoundTripTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> nv16Buffer;
+    std::vector<uint8_t> yuyvResultBuffer;
+    std::vector<uint8_t> i420Buffer;
+    std::vector<uint8_t> nv12Buffer;
+    std::vector<uint8_t> i420ResultBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    fileReaderWriter.readFileRaw("tests/inputs/input.i420", i420Buffer);
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+
+    // repacking without changing the chroma subsampling is lossless
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV16, yuyvBuffer, nv16Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_NV16, OrqaG2dFormat::FMT_YUYV, nv16Buffer, yuyvResultBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_I420, OrqaG2dFormat::FMT_NV12, i420Buffer, nv12Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_NV12, OrqaG2dFormat::FMT_I420, nv12Buffer, i420ResultBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    if (yuyvResultBuffer == yuyvBuffer && i420ResultBuffer == i420Buffer) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus CpuRGBAToNV12EncodeTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> rgbaBuffer;
+    std::vector<uint8_t> nv12Buffer;
+    std::vector<uint8_t> i420Buffer;
+    std::vector<uint8_t> nv12RepackedBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.rgba", rgbaBuffer);
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+
+    // encoding straight to NV12 must match encoding to I420 and repacking
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_NV12, rgbaBuffer, nv12Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_I420, rgbaBuffer, i420Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_I420, OrqaG2dFormat::FMT_NV12, i420Buffer, nv12RepackedBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    if (nv12Buffer != nv12RepackedBuffer) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+
+    // white is Y = 235 with neutral chroma in limited range BT.601
+    std::vector<uint8_t> whiteBuffer(640 * 480 * 4, 255);
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_NV12, whiteBuffer, nv12Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    const size_t lumaSize = 640 * 480;
+    for (size_t i = 0; i < nv12Buffer.size(); i++) {
+        if (nv12Buffer[i] != (i < lumaSize ? 235 : 128)) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+    return TestStatus::PASS;
+}
+
+TestStatus CpuRGBARepackRoundTripTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> rgbaBuffer;
+    std::vector<uint8_t> bgrxBuffer;
+    std::vector<uint8_t> rgbaResultBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.rgba", rgbaBuffer);
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_BGRX8888, rgbaBuffer, bgrxBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_BGRX8888, OrqaG2dFormat::FMT_RGBA8888, bgrxBuffer, rgbaResultBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    // colour survives the round trip, alpha comes back opaque
+    for (size_t i = 0; i < rgbaBuffer.size(); i += 4) {
+        if (
+            bgrxBuffer[i] != rgbaBuffer[i + 2] ||
+            rgbaResultBuffer[i] != rgbaBuffer[i] ||
+            rgbaResultBuffer[i + 1] != rgbaBuffer[i + 1] ||
+            rgbaResultBuffer[i + 2] != rgbaBuffer[i + 2] ||
+            rgbaResultBuffer[i + 3] != 255
+        ) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+    return TestStatus::PASS;
+}
+
+TestStatus InPlaceYUVReorderTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> nv12Buffer;
+    std::vector<uint8_t> nv21Buffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    fileReaderWriter.readFileRaw("tests/inputs/input.nv12", nv12Buffer);
+    fileReaderWriter.readFileRaw("tests/inputs/input.nv21", nv21Buffer);
+
+    std::vector<uint8_t> frame = yuyvBuffer;
+    if (
+        converter.convertImageInPlace(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_UYVY, frame, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    for (size_t i = 0; i < frame.size(); i += 2) {
+        if (frame[i] != yuyvBuffer[i + 1] || frame[i + 1] != yuyvBuffer[i]) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+    if (
+        converter.convertImageInPlace(OrqaG2dFormat::FMT_UYVY, OrqaG2dFormat::FMT_YUYV, frame, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        frame != yuyvBuffer
+    ) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+
+    // the NV21 input holds the same picture as the NV12 input
+    if (
+        converter.convertImageInPlace(OrqaG2dFormat::FMT_NV12, OrqaG2dFormat::FMT_NV21, nv12Buffer, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    if (nv12Buffer == nv21Buffer) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus FrameBufferConversionTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    G2dFrameBuffer yuyvFrame;
+    G2dFrameBuffer nv16Frame;
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> nv16Buffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvFrame);
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV16, yuyvFrame, nv16Frame, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV16, yuyvBuffer, nv16Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    if (
+        reinterpret_cast<uintptr_t>(yuyvFrame.data()) % G2dFrameMemory::Alignment != 0 ||
+        reinterpret_cast<uintptr_t>(nv16Frame.data()) % G2dFrameMemory::Alignment != 0
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    if (std::equal(nv16Frame.begin(), nv16Frame.end(), nv16Buffer.begin(), nv16Buffer.end())) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus AutotunedYUYVToNV16ConversionTest() {
+    const G2dTuningKey key = {OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV16, 640, 480};
+    const std::string tuningPath = (std::filesystem::temp_directory_path() / "g2d_tuning.txt").string();
+
+    G2dAutotuner autotuner(1, 2);
+    G2dTuningTable calibratedTable;
+    if (autotuner.calibrate({key}, calibratedTable) != G2dTuningStatus::SUCCESS || calibratedTable.save(tuningPath) != G2dTuningStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    auto loadedTable = std::make_shared<G2dTuningTable>();
+    G2dTuningStatus loadStatus = loadedTable->load(tuningPath);
+    std::filesystem::remove(tuningPath);
+    if (loadStatus != G2dTuningStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    std::optional<G2dTunedConfiguration> calibrated = calibratedTable.find(key);
+    std::optional<G2dTunedConfiguration> loaded = loadedTable->find(key);
+    if (
+        !calibrated.has_value() || !loaded.has_value() ||
+        loaded->backend != calibrated->backend ||
+        loaded->cpuOptions.threadCount != calibrated->cpuOptions.threadCount ||
+        loaded->cpuOptions.bandRows != calibrated->cpuOptions.bandRows
+    ) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+
+    G2dPixelFormatConverter tunedConverter;
+    G2dPixelFormatConverter cpuConverter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> tunedBuffer;
+    std::vector<uint8_t> cpuBuffer;
+
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+
+    tunedConverter.setTuningTable(loadedTable);
+    cpuConverter.setConversionBackend(G2dConversionBackend::CPU);
+    if (
+        tunedConverter.convertImage(key.srcFormat, key.destFormat, yuyvBuffer, tunedBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        cpuConverter.convertImage(key.srcFormat, key.destFormat, yuyvBuffer, cpuBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    // The accelerator may round chroma differently, so only CPU results are compared exactly
+    if (loaded->backend != G2dConversionBackend::CPU || tunedBuffer == cpuBuffer) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus FrameRingPipelineTest() {
+    constexpr size_t frameCount = 8;
+    const size_t yuyvSize = G2dFormatManager::getFrameSize(OrqaG2dFormat::FMT_YUYV, 640, 480).value_or(0);
+    const size_t nv16Size = G2dFormatManager::getFrameSize(OrqaG2dFormat::FMT_NV16, 640, 480).value_or(0);
+
+    G2dFrameRing captureRing;
+    G2dFrameRing encodeRing;
+    if (captureRing.create(yuyvSize, 2) != G2dFrameRingStatus::SUCCESS || encodeRing.create(nv16Size, 2) != G2dFrameRingStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    // the consumer maps the encode ring through duplicated descriptors, as a separate process would
+    G2dFrameRing encodeRingView;
+    const std::array<int, 3> encodeFds = encodeRing.fds();
+    if (encodeRingView.attach(dup(encodeFds[0]), dup(encodeFds[1]), dup(encodeFds[2])) != G2dFrameRingStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    FileReaderWriter fileReaderWriter;
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> nv16Expected;
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+
+    G2dPixelFormatConverter referenceConverter;
+    referenceConverter.setConversionBackend(G2dConversionBackend::CPU);
+    if (
+        referenceConverter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV16, yuyvBuffer, nv16Expected, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < frameCount; i++) {
+            std::span<uint8_t> slot;
+            if (captureRing.acquireWrite(slot) != G2dFrameRingStatus::SUCCESS) {
+                break;
+            }
+            std::copy(yuyvBuffer.begin(), yuyvBuffer.end(), slot.begin());
+            slot[0] = static_cast<uint8_t>(i);
+            captureRing.commitWrite();
+        }
+        captureRing.close();
+    });
+
+    G2dFrameRingConverter stage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV16, 640, 480);
+    stage.converter().setConversionBackend(G2dConversionBackend::CPU);
+    G2dFrameRingConverterStatus stageStatus = G2dFrameRingConverterStatus::SUCCESS;
+    std::thread converter([&]() {
+        stageStatus = stage.run(captureRing, encodeRing);
+    });
+
+    size_t received = 0;
+    bool matches = true;
+    std::span<uint8_t> slot;
+    while (encodeRingView.acquireRead(slot) == G2dFrameRingStatus::SUCCESS) {
+        // the first luma sample carries the frame number, the rest must match the reference
+        matches = matches && slot[0] == received &&
+            std::equal(nv16Expected.begin() + 1, nv16Expected.end(), slot.begin() + 1);
+        encodeRingView.releaseRead();
+        received++;
+    }
+
+    producer.join();
+    converter.join();
+
+    if (stageStatus != G2dFrameRingConverterStatus::SUCCESS) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    if (matches && received == frameCount) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus MultiOutputRGBAConversionTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> rgbaBuffer;
+    fileReaderWriter.readFileRaw("tests/inputs/input.rgba", rgbaBuffer);
+
+    const std::vector<OrqaG2dFormat> formats = {
+        OrqaG2dFormat::FMT_NV12,
+        OrqaG2dFormat::FMT_I420,
+        OrqaG2dFormat::FMT_YUYV,
+        OrqaG2dFormat::FMT_NV16,
+        OrqaG2dFormat::FMT_BGRX8888
+    };
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+
+    // every output of the single pass must match converting to it on its own
+    std::vector<std::vector<uint8_t>> fusedBuffers(formats.size());
+    std::vector<G2dConversionOutput> outputs;
+    for (size_t i = 0; i < formats.size(); i++) {
+        fusedBuffers[i].resize(*G2dFormatManager::getFrameSize(formats[i], 640, 480));
+        outputs.push_back({formats[i], 640, 480, fusedBuffers[i]});
+    }
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, rgbaBuffer, 640, 480, outputs)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    for (size_t i = 0; i < formats.size(); i++) {
+        std::vector<uint8_t> separateBuffer;
+        if (
+            converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, formats[i], rgbaBuffer, separateBuffer, 640, 480, 640, 480)
+                != G2dPixelFormatConverterStatus::SUCCESS
+        ) {
+            return TestStatus::GENERAL_TEST_FAILURE;
+        }
+        if (separateBuffer != fusedBuffers[i]) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+
+    return TestStatus::PASS;
+}
+
+TestStatus OverlayRGBAToNV12ConversionTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> rgbaBuffer;
+    std::vector<uint8_t> nv12Buffer;
+    std::vector<uint8_t> nv12Expected;
+    fileReaderWriter.readFileRaw("tests/inputs/input.rgba", rgbaBuffer);
+
+    // an opaque box of a single colour, and a layer hidden by its global alpha
+    const uint8_t boxColour[4] = {200, 40, 40, 255};
+    std::vector<uint8_t> boxPixels(64 * 32 * 4);
+    for (size_t i = 0; i < boxPixels.size(); i++) {
+        boxPixels[i] = boxColour[i % 4];
+    }
+    std::vector<uint8_t> hiddenPixels(16 * 16 * 4, 255);
+    const std::vector<G2dOverlayLayer> overlays = {
+        {boxPixels, 64, 32, 100, 50},
+        {hiddenPixels, 16, 16, 0, 0, 0}
+    };
+
+    std::vector<uint8_t> boxBlock(2 * 2 * 4);
+    std::vector<uint8_t> boxYuv;
+    for (size_t i = 0; i < boxBlock.size(); i++) {
+        boxBlock[i] = boxColour[i % 4];
+    }
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_NV12, rgbaBuffer, nv12Buffer, 640, 480, 640, 480, overlays)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_NV12, rgbaBuffer, nv12Expected, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_RGBA8888, OrqaG2dFormat::FMT_NV12, boxBlock, boxYuv, 2, 2, 2, 2)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    // inside the box the frame holds the box colour, everything else is untouched
+    for (size_t y = 50; y < 82; y++) {
+        std::fill_n(nv12Expected.begin() + (y * 640) + 100, 64, boxYuv[0]);
+    }
+    for (size_t y = 25; y < 41; y++) {
+        for (size_t x = 50; x < 82; x++) {
+            nv12Expected[(640 * 480) + (y * 640) + (2 * x)] = boxYuv[4];
+            nv12Expected[(640 * 480) + (y * 640) + (2 * x) + 1] = boxYuv[5];
+        }
+    }
+
+    if (nv12Buffer == nv12Expected) {
+        return TestStatus::PASS;
+    }
+    else {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+}
+
+TestStatus LumaPyramidTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> nv12Buffer;
+    std::vector<uint8_t> grayBuffer;
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+
+    converter.setConversionBackend(G2dConversionBackend::CPU);
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV12, yuyvBuffer, nv12Buffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS ||
+        converter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_GRAY8, yuyvBuffer, grayBuffer, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    G2dLumaPyramid planarPyramid;
+    G2dLumaPyramid packedPyramid;
+    if (
+        planarPyramid.build(OrqaG2dFormat::FMT_NV12, nv12Buffer, 640, 480, 4) != G2dLumaPyramidStatus::SUCCESS ||
+        packedPyramid.build(OrqaG2dFormat::FMT_YUYV, yuyvBuffer, 640, 480, 4) != G2dLumaPyramidStatus::SUCCESS ||
+        planarPyramid.levelCount() != 4 ||
+        packedPyramid.levelCount() != 4
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+
+    // the full size level of NV12 is its luma plane, the gray frame holds the same samples
+    const G2dLumaPyramidLevel& full = planarPyramid.level(0);
+    if (full.pixels.data() != nv12Buffer.data() || !std::equal(grayBuffer.begin(), grayBuffer.end(), full.pixels.begin())) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+
+    const G2dLumaPyramidLevel& half = planarPyramid.level(1);
+    if (half.width != 320 || half.height != 240 || planarPyramid.level(3).width != 80 || planarPyramid.level(3).height != 60) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+    for (size_t y = 0; y < half.height; y++) {
+        for (size_t x = 0; x < half.width; x++) {
+            const uint8_t* block = full.pixels.data() + (2 * y * full.width) + (2 * x);
+            if (half.pixels[(y * half.width) + x] != ((block[0] + block[1] + block[full.width] + block[full.width + 1] + 2) >> 2)) {
+                return TestStatus::INCORRECT_RESULT_FAILURE;
+            }
+        }
+    }
+
+    // the packed source carries the same luma, so every level matches
+    for (size_t i = 0; i < planarPyramid.levelCount(); i++) {
+        const std::span<const uint8_t> planar = planarPyramid.level(i).pixels;
+        const std::span<const uint8_t> packed = packedPyramid.level(i).pixels;
+        if (!std::equal(planar.begin(), planar.end(), packed.begin(), packed.end())) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+
+    return TestStatus::PASS;
+}
+
+TestStatus FrameSchedulerTest() {
+    G2dPixelFormatConverter converter;
+    FileReaderWriter fileReaderWriter;
+
+    std::vector<uint8_t> yuyvBuffer;
+    std::vector<uint8_t> nv12Expected;
+    std::vector<std::vector<uint8_t>> nv12Buffers(6);
+    fileReaderWriter.readFileRaw("tests/inputs/input.yuyv", yuyvBuffer);
+    if (
+        converter.convertImage(OrqaG2dFormat::FMT_YUYV, OrqaG2dFormat::FMT_NV12, yuyvBuffer, nv12Expected, 640, 480, 640, 480)
+            != G2dPixelFormatConverterStatus::SUCCESS
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    for (auto& buffer : nv12Buffers) {
+        buffer.resize(nv12Expected.size());
+    }
+
+    G2dFrameScheduler scheduler(1);
+    const size_t background = scheduler.addStream({0, 2, G2dOverflowPolicy::DROP_OLDEST});
+    const size_t urgent = scheduler.addStream({1, 1, G2dOverflowPolicy::DROP_NEWEST});
+
+    std::mutex resultMutex;
+    std::vector<std::optional<G2dFrameOutcome>> outcomes(nv12Buffers.size());
+    std::vector<size_t> completionOrder;
+    std::promise<void> allDone;
+    auto record = [&](size_t frame) {
+        return [&, frame](const G2dScheduledFrameResult& result) {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            outcomes[frame] = result.outcome;
+            completionOrder.push_back(frame);
+            if (completionOrder.size() == nv12Buffers.size()) {
+                allDone.set_value();
+            }
+        };
+    };
+
+    auto submit = [&](size_t stream, size_t frame, std::chrono::steady_clock::time_point deadline, G2dFrameScheduler::CompletionCallback callback) {
+        return scheduler.submit(
+            stream,
+            OrqaG2dFormat::FMT_YUYV,
+            OrqaG2dFormat::FMT_NV12,
+            yuyvBuffer,
+            nv12Buffers[frame],
+            640,
+            480,
+            640,
+            480,
+            deadline,
+            std::move(callback)
+        );
+    };
+
+    // the only worker is held in the callback of the first frame while the queues fill up
+    const auto later = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    std::promise<void> started;
+    std::promise<void> gate;
+    std::shared_future<void> gateOpen = gate.get_future().share();
+    auto recordFirst = record(0);
+    submit(background, 0, later, [&, recordFirst, gateOpen](const G2dScheduledFrameResult& result) {
+        started.set_value();
+        gateOpen.wait();
+        recordFirst(result);
+    });
+    started.get_future().wait();
+
+    if (
+        submit(background, 1, later, record(1)) != G2dFrameSchedulerStatus::SUCCESS ||
+        submit(background, 2, later, record(2)) != G2dFrameSchedulerStatus::SUCCESS ||
+        submit(background, 3, later, record(3)) != G2dFrameSchedulerStatus::SUCCESS ||
+        submit(background, 4, std::chrono::steady_clock::now() - std::chrono::milliseconds(1), record(4)) != G2dFrameSchedulerStatus::SUCCESS ||
+        submit(urgent, 5, later, record(5)) != G2dFrameSchedulerStatus::SUCCESS ||
+        submit(urgent, 0, later, record(0)) != G2dFrameSchedulerStatus::QUEUE_FULL_ERROR
+    ) {
+        return TestStatus::GENERAL_TEST_FAILURE;
+    }
+    gate.set_value();
+    allDone.get_future().wait();
+
+    // the frame pushed out of the full queue and the expired frame are reported first,
+    // then the urgent stream goes ahead of the frames queued before it
+    const std::vector<size_t> expectedOrder = {1, 4, 0, 5, 2, 3};
+    const std::optional<G2dStreamStats> backgroundStats = scheduler.stats(background);
+    const std::optional<G2dStreamStats> urgentStats = scheduler.stats(urgent);
+    if (
+        completionOrder != expectedOrder ||
+        outcomes[1] != G2dFrameOutcome::DROPPED_OVERFLOW ||
+        outcomes[4] != G2dFrameOutcome::DROPPED_STALE ||
+        backgroundStats->submitted != 5 ||
+        backgroundStats->converted != 3 ||
+        backgroundStats->droppedOverflow != 1 ||
+        backgroundStats->droppedStale != 1 ||
+        backgroundStats->peakQueueDepth != 2 ||
+        urgentStats->submitted != 2 ||
+        urgentStats->converted != 1 ||
+        urgentStats->droppedOverflow != 1
+    ) {
+        return TestStatus::INCORRECT_RESULT_FAILURE;
+    }
+
+    for (size_t frame : {0, 2, 3, 5}) {
+        if (outcomes[frame] != G2dFrameOutcome::CONVERTED || nv12Buffers[frame] != nv12Expected) {
+            return TestStatus::INCORRECT_RESULT_FAILURE;
+        }
+    }
+    return TestStatus::PASS;
+}
+
 int main() {
     std::vector<std::function<TestStatus()>> tests = {
         YUYVToRGBAConversionTest,
@@ -314,7 +1216,24 @@ int main() {
         UYVYToRGBAConversionTest,
         YV12ToRGBAConversionTest,
         YVYUToRGBAConversionTest,
-        YUYVToBGRXConversionTest    
+        YUYVToBGRXConversionTest,
+        ConversionServerYUYVToRGBATest,
+        ConcurrentConverterYUYVToRGBATest,
+        BulkYUYVToRGBAConversionTest,
+        CachedYUYVToRGBAConversionTest,
+        FrameHashReferenceTest,
+        IncrementalYUYVToRGBAConversionTest,
+        CpuYUVRepackRoundTripTest,
+        CpuRGBAToNV12EncodeTest,
+        CpuRGBARepackRoundTripTest,
+        InPlaceYUVReorderTest,
+        FrameBufferConversionTest,
+        AutotunedYUYVToNV16ConversionTest,
+        FrameRingPipelineTest,
+        MultiOutputRGBAConversionTest,
+        OverlayRGBAToNV12ConversionTest,
+        LumaPyramidTest,
+        FrameSchedulerTest
     };
 
     for (size_t i = 0; i < tests.size(); i++) {